@@ -0,0 +1,63 @@
+#include <atomic>
+
+#include "AllocationCounter.h"
+
+namespace
+{
+  ::std::atomic< ::std::size_t > allocations(0);
+
+  ::std::atomic< ::std::size_t > deallocations(0);
+
+  ::std::atomic< ::std::size_t > bytes(0);
+
+  ::std::atomic< ::std::size_t > live(0);
+
+  ::std::atomic< ::std::size_t > peak(0);
+}
+
+void
+AllocationCounter::allocated(const ::std::size_t& size, const ::std::size_t& usable)
+{
+  allocations.fetch_add(1, ::std::memory_order_relaxed);
+  bytes.fetch_add(size, ::std::memory_order_relaxed);
+
+  ::std::size_t current = live.fetch_add(usable, ::std::memory_order_relaxed) + usable;
+  ::std::size_t highest = peak.load(::std::memory_order_relaxed);
+
+  while (current > highest && !peak.compare_exchange_weak(highest, current, ::std::memory_order_relaxed))
+  {
+  }
+}
+
+void
+AllocationCounter::deallocated(const ::std::size_t& usable)
+{
+  deallocations.fetch_add(1, ::std::memory_order_relaxed);
+  live.fetch_sub(usable, ::std::memory_order_relaxed);
+}
+
+AllocationCounter::Snapshot
+AllocationCounter::get()
+{
+  Snapshot snapshot;
+  snapshot.allocations = allocations.load(::std::memory_order_relaxed);
+  snapshot.deallocations = deallocations.load(::std::memory_order_relaxed);
+  snapshot.bytes = bytes.load(::std::memory_order_relaxed);
+  snapshot.live = live.load(::std::memory_order_relaxed);
+  snapshot.peak = peak.load(::std::memory_order_relaxed);
+  return snapshot;
+}
+
+bool
+AllocationCounter::isInstalled()
+{
+  // Every process allocates before main, so no allocation means no hooks
+  return allocations.load(::std::memory_order_relaxed) > 0;
+}
+
+AllocationCounter::Snapshot
+AllocationCounter::resetPeak()
+{
+  peak.store(live.load(::std::memory_order_relaxed), ::std::memory_order_relaxed);
+  return get();
+}
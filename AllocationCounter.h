@@ -0,0 +1,49 @@
+#ifndef _ALLOCATION_COUNTER_H_
+#define _ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+/**
+*	Counts the heap allocations of the whole process. The counts are only kept if
+*	AllocationHooks.cpp, which replaces the allocation functions, is compiled into the
+*	executable itself, it does not take effect from a static library. With glibc malloc
+*	and friends are wrapped, which also covers the Eigen vectors; elsewhere only operator
+*	new and delete are, and live and peak bytes are not tracked.
+*/
+class AllocationCounter
+{
+public:
+  struct Snapshot
+  {
+    /** Calls of malloc, calloc, realloc, memalign or operator new */
+    ::std::size_t allocations;
+
+    /** Calls of free or operator delete with a non-null pointer */
+    ::std::size_t deallocations;
+
+    /** Requested bytes of all allocations */
+    ::std::size_t bytes;
+
+    /** Usable bytes of the blocks allocated right now */
+    ::std::size_t live;
+
+    /** Highest live bytes since the start of the process or the last resetPeak() */
+    ::std::size_t peak;
+  };
+
+  /** Counts since the start of the process */
+  static Snapshot get();
+
+  /** The allocation functions are replaced, otherwise all counts stay 0 */
+  static bool isInstalled();
+
+  /** Lowers the peak to the live bytes, so a later peak covers only what happened in between */
+  static Snapshot resetPeak();
+
+  /** Called by the replaced allocation functions, size is requested, usable what the block really holds */
+  static void allocated(const ::std::size_t& size, const ::std::size_t& usable);
+
+  static void deallocated(const ::std::size_t& usable);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+
+// glibc exports its allocator under these names as well, the public ones can be wrapped
+// without dlsym. operator new and delete end up here too.
+extern "C"
+{
+  void* __libc_malloc(::std::size_t size);
+  void* __libc_calloc(::std::size_t count, ::std::size_t size);
+  void* __libc_realloc(void* pointer, ::std::size_t size);
+  void* __libc_memalign(::std::size_t alignment, ::std::size_t size);
+  void __libc_free(void* pointer);
+
+  static void* countAllocation(void* pointer, ::std::size_t size)
+  {
+    if (NULL != pointer)
+    {
+      AllocationCounter::allocated(size, malloc_usable_size(pointer));
+    }
+
+    return pointer;
+  }
+
+  void* malloc(::std::size_t size) throw()
+  {
+    return countAllocation(__libc_malloc(size), size);
+  }
+
+  void* calloc(::std::size_t count, ::std::size_t size) throw()
+  {
+    return countAllocation(__libc_calloc(count, size), count * size);
+  }
+
+  void* realloc(void* pointer, ::std::size_t size) throw()
+  {
+    // The old block is gone if a new one is returned, or if size is 0
+    ::std::size_t usable = NULL != pointer ? malloc_usable_size(pointer) : 0;
+    void* result = __libc_realloc(pointer, size);
+
+    if (NULL != pointer && (NULL != result || 0 == size))
+    {
+      AllocationCounter::deallocated(usable);
+    }
+
+    return countAllocation(result, size);
+  }
+
+  void* memalign(::std::size_t alignment, ::std::size_t size) throw()
+  {
+    return countAllocation(__libc_memalign(alignment, size), size);
+  }
+
+  void* aligned_alloc(::std::size_t alignment, ::std::size_t size) throw()
+  {
+    return countAllocation(__libc_memalign(alignment, size), size);
+  }
+
+  int posix_memalign(void** pointer, ::std::size_t alignment, ::std::size_t size) throw()
+  {
+    *pointer = countAllocation(__libc_memalign(alignment, size), size);
+    return NULL == *pointer ? ENOMEM : 0;
+  }
+
+  void free(void* pointer) throw()
+  {
+    if (NULL != pointer)
+    {
+      AllocationCounter::deallocated(malloc_usable_size(pointer));
+    }
+
+    __libc_free(pointer);
+  }
+}
+#else
+void*
+operator new(::std::size_t size)
+{
+  AllocationCounter::allocated(size, 0);
+
+  void* pointer = ::std::malloc(0 == size ? 1 : size);
+
+  if (NULL == pointer)
+  {
+    throw ::std::bad_alloc();
+  }
+
+  return pointer;
+}
+
+void*
+operator new[](::std::size_t size)
+{
+  return operator new(size);
+}
+
+void
+operator delete(void* pointer) throw()
+{
+  if (NULL != pointer)
+  {
+    AllocationCounter::deallocated(0);
+  }
+
+  ::std::free(pointer);
+}
+
+void
+operator delete[](void* pointer) throw()
+{
+  operator delete(pointer);
+}
+#endif
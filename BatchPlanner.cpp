@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "BatchPlanner.h"
+#include "Trace.h"
+#include "rl/math/Unit.h"
+
+BatchPlanner::BatchPlanner(const std::vector<TutorialPlanSystem*>& systems) :
+  wallTime(0),
+  systems(systems)
+{
+  for (size_t i = 0; i < this->systems.size(); ++i)
+  {
+    this->queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+  }
+}
+
+BatchPlanner::~BatchPlanner()
+{
+}
+
+bool BatchPlanner::readQueries(const std::string& filename, std::size_t dof, std::vector<Query>& queries)
+{
+  std::ifstream file(filename.c_str());
+
+  if (!file)
+  {
+    return false;
+  }
+
+  std::string line;
+
+  while (std::getline(file, line))
+  {
+    line = line.substr(0, line.find('#'));
+
+    std::istringstream values(line);
+    std::vector<rl::math::Real> angles;
+    rl::math::Real angle;
+
+    while (values >> angle)
+    {
+      angles.push_back(angle * rl::math::DEG2RAD);
+    }
+
+    if (angles.empty())
+    {
+      continue;
+    }
+
+    if (angles.size() != 2 * dof)
+    {
+      return false;
+    }
+
+    Query query;
+    query.start = Eigen::Map<rl::math::Vector>(angles.data(), dof);
+    query.goal = Eigen::Map<rl::math::Vector>(angles.data() + dof, dof);
+    queries.push_back(query);
+  }
+
+  return true;
+}
+
+bool BatchPlanner::pop(std::size_t worker, std::size_t& index)
+{
+  //  Own queue from the back, other queues from the front
+  for (size_t i = 0; i < this->queues.size(); ++i)
+  {
+    WorkQueue& queue = *this->queues[(worker + i) % this->queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.indices.empty())
+    {
+      continue;
+    }
+
+    if (0 == i)
+    {
+      index = queue.indices.back();
+      queue.indices.pop_back();
+    }
+    else
+    {
+      index = queue.indices.front();
+      queue.indices.pop_front();
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+std::vector<QueryResult> BatchPlanner::run(const std::vector<Query>& queries)
+{
+  std::vector<QueryResult> results(queries.size());
+
+  if (this->systems.empty())
+  {
+    return results;
+  }
+
+  //  Deal the queries round robin, stealing balances queries of different difficulty
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    this->queues[i % this->queues.size()]->indices.push_back(i);
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < this->systems.size(); ++i)
+  {
+    threads.push_back(std::thread(&BatchPlanner::work, this, i, std::cref(queries), std::ref(results)));
+  }
+
+  for (size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i].join();
+  }
+
+  std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+  this->wallTime = std::chrono::duration_cast< std::chrono::duration<double>>(stop - start).count() * 1000;
+
+  return results;
+}
+
+void BatchPlanner::work(std::size_t worker, const std::vector<Query>& queries, std::vector<QueryResult>& results)
+{
+  TRACE_THREAD_NAME("worker " + std::to_string(worker));
+
+  TutorialPlanSystem& system = *this->systems[worker];
+  size_t index;
+
+  while (this->pop(worker, index))
+  {
+    TRACE_SCOPE("query", "batch");
+
+    rl::math::Vector start = queries[index].start;
+    rl::math::Vector goal = queries[index].goal;
+
+    system.reset();
+    system.setStartConfiguration(start);
+    system.setGoalConfiguration(goal);
+
+    rl::plan::VectorList path;
+    results[index].index = index;
+    results[index].worker = worker;
+    system.solveQuery(path, results[index].result);
+  }
+}
+
+void BatchPlanner::writeResults(std::ostream& out, const std::vector<QueryResult>& results)
+{
+  out << "index,worker,solved,duration,vertices,queries,free_queries,length" << std::endl;
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const PlanResult& result = results[i].result;
+    out << results[i].index << "," << results[i].worker << "," << (result.solved ? "true" : "false") << ","
+        << result.duration << "," << result.vertices << "," << result.totalQueries << ","
+        << result.freeQueries << "," << result.length << std::endl;
+  }
+}
+
+void BatchPlanner::writeSummary(std::ostream& out, const std::vector<QueryResult>& results) const
+{
+  std::vector<double> durations;
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    if (results[i].result.solved)
+    {
+      durations.push_back(results[i].result.duration);
+    }
+  }
+
+  std::sort(durations.begin(), durations.end());
+
+  out << "queries: " << results.size() << ", solved: " << durations.size() << std::endl;
+
+  if (!durations.empty())
+  {
+    out << "latency [ms]: median " << durations[durations.size() / 2]
+        << ", max " << durations.back() << std::endl;
+  }
+
+  out << "workers: " << this->systems.size() << ", wall time: " << this->wallTime << " ms, throughput: "
+      << (this->wallTime > 0 ? results.size() / (this->wallTime / 1000) : 0) << " queries/s" << std::endl;
+}
@@ -0,0 +1,69 @@
+#ifndef _BATCH_PLANNER_H_
+#define _BATCH_PLANNER_H_
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "TutorialPlanSystem.h"
+
+//  One start/goal pair of a batch
+struct Query
+{
+  rl::math::Vector start;
+  rl::math::Vector goal;
+};
+
+//  Result of one query of a batch
+struct QueryResult
+{
+  std::size_t index; //position of the query in the batch
+  std::size_t worker; //thread that planned it
+  PlanResult result;
+};
+
+//  Plans many queries on a work-stealing thread pool.
+//  Every worker owns one TutorialPlanSystem, i.e. its own model, sampler and planner, so
+//  the queries do not share any state. The systems have to be created by the caller
+//  beforehand, as loading the scenes is not thread safe.
+class BatchPlanner
+{
+public:
+  BatchPlanner(const std::vector<TutorialPlanSystem*>& systems);
+  virtual ~BatchPlanner();
+
+  //  Reads one query per line: dof start angles followed by dof goal angles in degrees, # starts a comment
+  static bool readQueries(const std::string& filename, std::size_t dof, std::vector<Query>& queries);
+
+  //  Plans all queries, the results are in the order of the queries
+  std::vector<QueryResult> run(const std::vector<Query>& queries);
+
+  //  One CSV line per query: index, worker, solved, duration [ms], vertices, collision queries, free queries, length
+  static void writeResults(std::ostream& out, const std::vector<QueryResult>& results);
+
+  //  Solve rate, latency and throughput of the last run()
+  void writeSummary(std::ostream& out, const std::vector<QueryResult>& results) const;
+
+  double wallTime; //[ms] of the last run()
+
+private:
+  struct WorkQueue
+  {
+    std::mutex mutex;
+    std::deque<std::size_t> indices;
+  };
+
+  //  Takes the next query of worker, or steals one from the others if its own queue is empty
+  bool pop(std::size_t worker, std::size_t& index);
+
+  void work(std::size_t worker, const std::vector<Query>& queries, std::vector<QueryResult>& results);
+
+  std::vector<TutorialPlanSystem*> systems;
+
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+};
+
+#endif
@@ -0,0 +1,704 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include "Benchmark.h"
+#include "Report.h"
+
+namespace
+{
+  //  Nearest-rank percentile of sorted values, NaN if there are none
+  double percentile(const std::vector<double>& sorted, double p)
+  {
+    if (sorted.empty())
+    {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::max<std::size_t>(rank, 1) - 1];
+  }
+
+  double milliseconds(const std::chrono::steady_clock::duration& duration)
+  {
+    return std::chrono::duration_cast< std::chrono::duration<double, std::milli> >(duration).count();
+  }
+
+  //  How the tree bytes are estimated, written next to them in the JSON as the est_* columns only hold on this allocator
+  const char* memoryModel = "glibc malloc chunks of libstdc++ list nodes, see YourPlanner::getVertexMemory()";
+
+  //  Estimated bytes of tree i, 0 for the other planners
+  std::size_t treeBytes(const PlanResult& result, std::size_t i)
+  {
+    return i < result.treeBytes.size() ? result.treeBytes[i] : 0;
+  }
+
+  std::size_t treeBytes(const PlanResult& result)
+  {
+    std::size_t bytes = 0;
+
+    for (std::size_t i = 0; i < result.treeBytes.size(); ++i)
+    {
+      bytes += result.treeBytes[i];
+    }
+
+    return bytes;
+  }
+
+  //  Counter columns are only written if the counters could be read at all
+  bool counted(const std::vector<BenchmarkTrial>& trials)
+  {
+    for (std::size_t i = 0; i < trials.size(); ++i)
+    {
+      if (trials[i].counters.valid)
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool counted(const std::vector<BenchmarkStatistics>& statistics)
+  {
+    for (std::size_t i = 0; i < statistics.size(); ++i)
+    {
+      if (statistics[i].counted > 0)
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  //  Fields of one CSV line, empty ones included
+  std::vector<std::string> split(const std::string& line)
+  {
+    std::vector<std::string> fields(1);
+
+    for (std::size_t i = 0; i < line.size(); ++i)
+    {
+      if (',' == line[i])
+      {
+        fields.push_back(std::string());
+      }
+      else if ('\r' != line[i])
+      {
+        fields.back() += line[i];
+      }
+    }
+
+    return fields;
+  }
+}
+
+Benchmark::Benchmark(TutorialPlanSystem& system) :
+  seed(1),
+  timeout(std::chrono::seconds(60)),
+  onTrial(),
+  perfCounters(NULL),
+  system(system),
+  defaults()
+{
+  const std::vector<std::string>& names = flagNames();
+
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    this->defaults.push_back(std::make_pair(names[i], *flag(this->system.getYourPlanner(), names[i])));
+  }
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+std::vector<BenchmarkConfiguration> Benchmark::defaultConfigurations()
+{
+  std::vector<BenchmarkConfiguration> configurations;
+
+  BenchmarkConfiguration reference;
+  reference.name = "rrt_con_con";
+  reference.reference = true;
+  configurations.push_back(reference);
+
+  BenchmarkConfiguration planner;
+  planner.name = "your_planner";
+  planner.reference = false;
+  configurations.push_back(planner);
+
+  BenchmarkConfiguration plain;
+  plain.name = "plain";
+  plain.reference = false;
+
+  const std::vector<std::string>& names = flagNames();
+
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    plain.flags.push_back(std::make_pair(names[i], false));
+  }
+
+  configurations.push_back(plain);
+
+  //  Anytime mode runs until its deadline, warm start needs a sequence of queries,
+  //  and informed sampling and warm start validation only matter together with them, so they are not measured alone.
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    if ("use_anytime" == names[i] || "use_warm_start" == names[i] || "use_informed_sampling" == names[i] || "use_warm_start_validation" == names[i])
+    {
+      continue;
+    }
+
+    BenchmarkConfiguration single = plain;
+    single.name = names[i].substr(4);
+    single.flags.push_back(std::make_pair(names[i], true));
+    configurations.push_back(single);
+  }
+
+  return configurations;
+}
+
+const char* Benchmark::getBuild()
+{
+#ifdef TUTORIAL_PLAN_BUILD
+  return TUTORIAL_PLAN_BUILD;
+#else
+  return "unknown";
+#endif
+}
+
+const std::vector<std::string>& Benchmark::flagNames()
+{
+  static const std::vector<std::string> names = {
+    "use_goal_bias",
+    "use_neighbor_exhaustion",
+    "use_gaussian_sampling",
+    "use_bridge_sampling",
+    "use_better_connect",
+    "use_weighted_distance_metric",
+    "use_gaussian_along_c_path",
+    "use_workspace_sampling",
+    "use_anytime",
+    "use_warm_start",
+    "use_warm_start_validation",
+    "use_dynamic_domain",
+    "use_informed_sampling",
+    "use_local_trees",
+    "use_gap_tracking"
+  };
+
+  return names;
+}
+
+bool* Benchmark::flag(YourPlanner& planner, const std::string& name)
+{
+  if ("use_goal_bias" == name) return &planner.use_goal_bias;
+  if ("use_neighbor_exhaustion" == name) return &planner.use_neighbor_exhaustion;
+  if ("use_gaussian_sampling" == name) return &planner.use_gaussian_sampling;
+  if ("use_bridge_sampling" == name) return &planner.use_bridge_sampling;
+  if ("use_better_connect" == name) return &planner.use_better_connect;
+  if ("use_weighted_distance_metric" == name) return &planner.use_weighted_distance_metric;
+  if ("use_gaussian_along_c_path" == name) return &planner.use_gaussian_along_c_path;
+  if ("use_workspace_sampling" == name) return &planner.use_workspace_sampling;
+  if ("use_anytime" == name) return &planner.use_anytime;
+  if ("use_warm_start" == name) return &planner.use_warm_start;
+  if ("use_warm_start_validation" == name) return &planner.use_warm_start_validation;
+  if ("use_dynamic_domain" == name) return &planner.use_dynamic_domain;
+  if ("use_informed_sampling" == name) return &planner.use_informed_sampling;
+  if ("use_local_trees" == name) return &planner.use_local_trees;
+  if ("use_gap_tracking" == name) return &planner.use_gap_tracking;
+  return NULL;
+}
+
+void Benchmark::configure(const BenchmarkConfiguration& configuration)
+{
+  YourPlanner& planner = this->system.getYourPlanner();
+
+  for (std::size_t i = 0; i < this->defaults.size(); ++i)
+  {
+    *flag(planner, this->defaults[i].first) = this->defaults[i].second;
+  }
+
+  for (std::size_t i = 0; i < configuration.flags.size(); ++i)
+  {
+    bool* value = flag(planner, configuration.flags[i].first);
+
+    if (NULL != value)
+    {
+      *value = configuration.flags[i].second;
+    }
+  }
+
+  this->system.setUseReference(configuration.reference);
+  this->system.getPlanner().duration = this->timeout;
+}
+
+std::vector<BenchmarkTrial> Benchmark::run(const Scenario& scenario, const std::vector<BenchmarkConfiguration>& configurations, std::size_t trials)
+{
+  std::vector<BenchmarkTrial> results;
+
+  for (std::size_t i = 0; i < scenario.queries.size(); ++i)
+  {
+    rl::math::Vector start = scenario.queries[i].start;
+    rl::math::Vector goal = scenario.queries[i].goal;
+
+    for (std::size_t j = 0; j < configurations.size(); ++j)
+    {
+      this->configure(configurations[j]);
+
+      for (std::size_t k = 0; k < trials; ++k)
+      {
+        BenchmarkTrial trial;
+        trial.scenario = scenario.name;
+        trial.query = scenario.queries[i].name;
+        trial.difficulty = scenario.queries[i].difficulty;
+        trial.configuration = configurations[j].name;
+        trial.trial = k;
+        trial.seed = this->seed + static_cast<std::mt19937::result_type>(k);
+
+        this->system.reset();
+        this->system.setStartConfiguration(start);
+        this->system.setGoalConfiguration(goal);
+        this->system.seed(trial.seed);
+
+        if (NULL != this->perfCounters && this->perfCounters->isOpen())
+        {
+          PerfCounters* counters = this->perfCounters;
+          this->system.setSolveHooks([counters]() { counters->start(); }, [counters, &trial]() { trial.counters = counters->stop(); });
+        }
+
+        rl::plan::VectorList path;
+        this->system.solveQuery(path, trial.result);
+        this->system.setSolveHooks(std::function<void()>(), std::function<void()>());
+        results.push_back(trial);
+
+        if (this->onTrial)
+        {
+          this->onTrial(trial);
+        }
+      }
+    }
+  }
+
+  return results;
+}
+
+std::vector<BenchmarkStatistics> Benchmark::summarize(const std::vector<BenchmarkTrial>& trials)
+{
+  std::vector<BenchmarkStatistics> statistics;
+
+  std::size_t begin = 0;
+
+  while (begin < trials.size())
+  {
+    std::size_t end = begin;
+
+    while (end < trials.size() && trials[end].scenario == trials[begin].scenario && trials[end].query == trials[begin].query && trials[end].configuration == trials[begin].configuration)
+    {
+      ++end;
+    }
+
+    std::vector<double> durations;
+    std::vector<double> vertices;
+    std::vector<double> totalQueries;
+    std::vector<double> freeQueries;
+    std::vector<double> tree;
+    std::vector<double> vertex;
+    std::vector<double> peak;
+    std::vector<double> allocations;
+    std::vector<double> cycles;
+    std::vector<double> instructions;
+    std::vector<double> ipc;
+    std::vector<double> cacheMpki;
+    std::vector<double> branchMpki;
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      const PlanResult& result = trials[i].result;
+
+      if (trials[i].counters.valid)
+      {
+        cycles.push_back(trials[i].counters.count[PerfCounters::COUNTER_CYCLES]);
+        instructions.push_back(trials[i].counters.count[PerfCounters::COUNTER_INSTRUCTIONS]);
+        ipc.push_back(trials[i].counters.getIpc());
+        cacheMpki.push_back(trials[i].counters.getMpki(PerfCounters::COUNTER_CACHE_MISSES));
+        branchMpki.push_back(trials[i].counters.getMpki(PerfCounters::COUNTER_BRANCH_MISSES));
+      }
+
+      if (result.solved)
+      {
+        durations.push_back(result.duration);
+      }
+
+      vertices.push_back(result.vertices);
+      totalQueries.push_back(result.totalQueries);
+      freeQueries.push_back(result.freeQueries);
+      tree.push_back(treeBytes(result));
+      vertex.push_back(result.vertexBytes);
+      peak.push_back(result.peakBytes);
+      allocations.push_back(result.allocations);
+    }
+
+    std::sort(durations.begin(), durations.end());
+
+    BenchmarkStatistics entry;
+    entry.scenario = trials[begin].scenario;
+    entry.query = trials[begin].query;
+    entry.difficulty = trials[begin].difficulty;
+    entry.configuration = trials[begin].configuration;
+    entry.trials = end - begin;
+    entry.solved = durations.size();
+    entry.solveRate = static_cast<double>(entry.solved) / entry.trials;
+    entry.median = percentile(durations, 0.5);
+    entry.p90 = percentile(durations, 0.9);
+    entry.p99 = percentile(durations, 0.99);
+    entry.vertices = median(vertices);
+    entry.totalQueries = median(totalQueries);
+    entry.freeQueries = median(freeQueries);
+    entry.treeBytes = median(tree);
+    entry.vertexBytes = median(vertex);
+    entry.peakBytes = median(peak);
+    entry.allocations = median(allocations);
+    entry.counted = cycles.size();
+    entry.cycles = median(cycles);
+    entry.instructions = median(instructions);
+    entry.ipc = median(ipc);
+    entry.cacheMpki = median(cacheMpki);
+    entry.branchMpki = median(branchMpki);
+    statistics.push_back(entry);
+
+    begin = end;
+  }
+
+  return statistics;
+}
+
+void Benchmark::writeTrials(std::ostream& out, const std::vector<BenchmarkTrial>& trials)
+{
+  out << "scenario,query,difficulty,configuration,trial,seed,solved,duration,vertices,queries,free_queries,length";
+  out << ",est_tree_bytes,est_start_tree_bytes,est_goal_tree_bytes,est_vertex_bytes,peak_bytes,allocations";
+
+  if (SolveProfile::isEnabled())
+  {
+    for (std::size_t i = 0; i < SolveProfile::PHASE_COUNT; ++i)
+    {
+      const char* phase = SolveProfile::getName(static_cast<SolveProfile::Phase>(i));
+      out << "," << phase << "_duration," << phase << "_calls," << phase << "_queries";
+    }
+
+    out << ",connect_steps,exhausted_skips";
+  }
+
+  bool counters = counted(trials);
+
+  if (counters)
+  {
+    for (std::size_t i = 0; i < PerfCounters::COUNTER_COUNT; ++i)
+    {
+      out << "," << PerfCounters::getName(static_cast<PerfCounters::Counter>(i));
+    }
+  }
+
+  out << std::endl;
+
+  for (std::size_t i = 0; i < trials.size(); ++i)
+  {
+    const PlanResult& result = trials[i].result;
+    out << trials[i].scenario << "," << trials[i].query << "," << ScenarioQuery::getName(trials[i].difficulty) << ","
+        << trials[i].configuration << "," << trials[i].trial << "," << trials[i].seed << ","
+        << (result.solved ? "true" : "false") << "," << result.duration << "," << result.vertices << ","
+        << result.totalQueries << "," << result.freeQueries << "," << result.length;
+    out << "," << treeBytes(result) << "," << treeBytes(result, 0) << "," << treeBytes(result, 1) << "," << result.vertexBytes
+        << "," << result.peakBytes << "," << result.allocations;
+
+    if (SolveProfile::isEnabled())
+    {
+      for (std::size_t j = 0; j < SolveProfile::PHASE_COUNT; ++j)
+      {
+        out << "," << milliseconds(result.profile.duration[j]) << "," << result.profile.calls[j] << "," << result.profile.queries[j];
+      }
+
+      out << "," << result.profile.connectSteps << "," << result.profile.exhaustedSkips;
+    }
+
+    if (counters)
+    {
+      //  Trials that were not counted keep their columns empty
+      for (std::size_t j = 0; j < PerfCounters::COUNTER_COUNT; ++j)
+      {
+        out << ",";
+
+        if (trials[i].counters.valid)
+        {
+          out << trials[i].counters.count[j];
+        }
+      }
+    }
+
+    out << std::endl;
+  }
+}
+
+bool Benchmark::readTrials(std::istream& in, std::vector<BenchmarkTrial>& trials)
+{
+  std::string line;
+
+  if (!std::getline(in, line))
+  {
+    return false;
+  }
+
+  std::vector<std::string> names = split(line);
+  std::map<std::string, std::size_t> columns;
+
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    columns[names[i]] = i;
+  }
+
+  //  Files written before the tree bytes were marked as estimates
+  const char* estimated[] = {"tree_bytes", "start_tree_bytes", "goal_tree_bytes", "vertex_bytes"};
+
+  for (std::size_t i = 0; i < sizeof(estimated) / sizeof(estimated[0]); ++i)
+  {
+    if (columns.end() != columns.find(estimated[i]) && columns.end() == columns.find(std::string("est_") + estimated[i]))
+    {
+      columns[std::string("est_") + estimated[i]] = columns[estimated[i]];
+    }
+  }
+
+  const char* required[] = {"scenario", "query", "difficulty", "configuration", "trial", "seed", "solved", "duration", "vertices", "queries", "free_queries", "length"};
+
+  for (std::size_t i = 0; i < sizeof(required) / sizeof(required[0]); ++i)
+  {
+    if (columns.end() == columns.find(required[i]))
+    {
+      return false;
+    }
+  }
+
+  while (std::getline(in, line))
+  {
+    if (line.empty())
+    {
+      continue;
+    }
+
+    std::vector<std::string> fields = split(line);
+
+    if (fields.size() != names.size())
+    {
+      return false;
+    }
+
+    BenchmarkTrial trial;
+    trial.scenario = fields[columns["scenario"]];
+    trial.query = fields[columns["query"]];
+    trial.configuration = fields[columns["configuration"]];
+
+    if (!ScenarioQuery::parse(fields[columns["difficulty"]], trial.difficulty))
+    {
+      return false;
+    }
+
+    trial.trial = std::strtoul(fields[columns["trial"]].c_str(), NULL, 10);
+    trial.seed = std::strtoul(fields[columns["seed"]].c_str(), NULL, 10);
+
+    PlanResult& result = trial.result;
+    result.valid = true;
+    result.solved = "true" == fields[columns["solved"]];
+    result.reused = false;
+    result.duration = std::strtod(fields[columns["duration"]].c_str(), NULL);
+    result.vertices = std::strtoul(fields[columns["vertices"]].c_str(), NULL, 10);
+    result.totalQueries = std::strtoul(fields[columns["queries"]].c_str(), NULL, 10);
+    result.freeQueries = std::strtoul(fields[columns["free_queries"]].c_str(), NULL, 10);
+    result.length = std::strtod(fields[columns["length"]].c_str(), NULL);
+    result.profile.reset();
+
+    //  Written since memory is measured, stay 0 for older files
+    result.vertexBytes = 0;
+    result.peakBytes = 0;
+    result.allocations = 0;
+
+    if (columns.end() != columns.find("est_start_tree_bytes") && columns.end() != columns.find("est_goal_tree_bytes") && columns.end() != columns.find("est_tree_bytes"))
+    {
+      std::size_t start = std::strtoul(fields[columns["est_start_tree_bytes"]].c_str(), NULL, 10);
+      std::size_t goal = std::strtoul(fields[columns["est_goal_tree_bytes"]].c_str(), NULL, 10);
+      std::size_t total = std::strtoul(fields[columns["est_tree_bytes"]].c_str(), NULL, 10);
+      result.treeBytes.push_back(start);
+      result.treeBytes.push_back(goal);
+      //  The local trees, 0 if the file is inconsistent
+      result.treeBytes.push_back(total > start + goal ? total - start - goal : 0);
+    }
+
+    if (columns.end() != columns.find("est_vertex_bytes"))
+    {
+      result.vertexBytes = std::strtod(fields[columns["est_vertex_bytes"]].c_str(), NULL);
+    }
+
+    if (columns.end() != columns.find("peak_bytes"))
+    {
+      result.peakBytes = std::strtoul(fields[columns["peak_bytes"]].c_str(), NULL, 10);
+    }
+
+    if (columns.end() != columns.find("allocations"))
+    {
+      result.allocations = std::strtoul(fields[columns["allocations"]].c_str(), NULL, 10);
+    }
+
+    trials.push_back(trial);
+  }
+
+  return true;
+}
+
+void Benchmark::writeStatistics(std::ostream& out, const std::vector<BenchmarkStatistics>& statistics)
+{
+  bool counters = counted(statistics);
+
+  out << "scenario,query,difficulty,configuration,trials,solved,solve_rate,median,p90,p99,vertices,queries,free_queries";
+  out << ",est_tree_bytes,est_vertex_bytes,peak_bytes,allocations";
+
+  if (counters)
+  {
+    out << ",counted,cycles,instructions,ipc,cache_mpki,branch_mpki";
+  }
+
+  out << std::endl;
+
+  for (std::size_t i = 0; i < statistics.size(); ++i)
+  {
+    const BenchmarkStatistics& entry = statistics[i];
+    out << entry.scenario << "," << entry.query << "," << ScenarioQuery::getName(entry.difficulty) << "," << entry.configuration << "," << entry.trials << "," << entry.solved << "," << entry.solveRate << ",";
+    writeNumber(out, entry.median, false);
+    out << ",";
+    writeNumber(out, entry.p90, false);
+    out << ",";
+    writeNumber(out, entry.p99, false);
+    out << "," << entry.vertices << "," << entry.totalQueries << "," << entry.freeQueries;
+    out << "," << entry.treeBytes << "," << entry.vertexBytes << "," << entry.peakBytes << "," << entry.allocations;
+
+    if (counters)
+    {
+      out << "," << entry.counted << ",";
+      writeNumber(out, entry.cycles, false);
+      out << ",";
+      writeNumber(out, entry.instructions, false);
+      out << ",";
+      writeNumber(out, entry.ipc, false);
+      out << ",";
+      writeNumber(out, entry.cacheMpki, false);
+      out << ",";
+      writeNumber(out, entry.branchMpki, false);
+    }
+
+    out << std::endl;
+  }
+}
+
+void Benchmark::writeJson(std::ostream& out, const std::vector<BenchmarkTrial>& trials, const std::vector<BenchmarkStatistics>& statistics)
+{
+  out << "{" << std::endl << "  \"build\": ";
+  writeString(out, getBuild());
+  out << "," << std::endl << "  \"memory_model\": ";
+  writeString(out, memoryModel);
+  out << "," << std::endl << "  \"statistics\": [";
+
+  for (std::size_t i = 0; i < statistics.size(); ++i)
+  {
+    const BenchmarkStatistics& entry = statistics[i];
+    out << (i > 0 ? "," : "") << std::endl << "    {\"scenario\": ";
+    writeString(out, entry.scenario);
+    out << ", \"query\": ";
+    writeString(out, entry.query);
+    out << ", \"difficulty\": ";
+    writeString(out, ScenarioQuery::getName(entry.difficulty));
+    out << ", \"configuration\": ";
+    writeString(out, entry.configuration);
+    out << ", \"trials\": " << entry.trials << ", \"solved\": " << entry.solved << ", \"solve_rate\": " << entry.solveRate;
+    out << ", \"median\": ";
+    writeNumber(out, entry.median, true);
+    out << ", \"p90\": ";
+    writeNumber(out, entry.p90, true);
+    out << ", \"p99\": ";
+    writeNumber(out, entry.p99, true);
+    out << ", \"vertices\": " << entry.vertices << ", \"queries\": " << entry.totalQueries << ", \"free_queries\": " << entry.freeQueries;
+    out << ", \"est_tree_bytes\": " << entry.treeBytes << ", \"est_vertex_bytes\": " << entry.vertexBytes
+        << ", \"peak_bytes\": " << entry.peakBytes << ", \"allocations\": " << entry.allocations;
+
+    if (entry.counted > 0)
+    {
+      out << ", \"counters\": {\"counted\": " << entry.counted << ", \"cycles\": ";
+      writeNumber(out, entry.cycles, true);
+      out << ", \"instructions\": ";
+      writeNumber(out, entry.instructions, true);
+      out << ", \"ipc\": ";
+      writeNumber(out, entry.ipc, true);
+      out << ", \"cache_mpki\": ";
+      writeNumber(out, entry.cacheMpki, true);
+      out << ", \"branch_mpki\": ";
+      writeNumber(out, entry.branchMpki, true);
+      out << "}";
+    }
+
+    out << "}";
+  }
+
+  out << std::endl << "  ]," << std::endl << "  \"trials\": [";
+
+  for (std::size_t i = 0; i < trials.size(); ++i)
+  {
+    const PlanResult& result = trials[i].result;
+    out << (i > 0 ? "," : "") << std::endl << "    {\"scenario\": ";
+    writeString(out, trials[i].scenario);
+    out << ", \"query\": ";
+    writeString(out, trials[i].query);
+    out << ", \"difficulty\": ";
+    writeString(out, ScenarioQuery::getName(trials[i].difficulty));
+    out << ", \"configuration\": ";
+    writeString(out, trials[i].configuration);
+    out << ", \"trial\": " << trials[i].trial << ", \"seed\": " << trials[i].seed
+        << ", \"solved\": " << (result.solved ? "true" : "false") << ", \"duration\": " << result.duration
+        << ", \"vertices\": " << result.vertices << ", \"queries\": " << result.totalQueries
+        << ", \"free_queries\": " << result.freeQueries << ", \"length\": " << result.length;
+
+    out << ", \"memory\": {\"est_trees\": [";
+
+    for (std::size_t j = 0; j < result.treeBytes.size(); ++j)
+    {
+      out << (j > 0 ? ", " : "") << result.treeBytes[j];
+    }
+
+    out << "], \"est_vertex_bytes\": " << result.vertexBytes << ", \"peak_bytes\": " << result.peakBytes << ", \"allocations\": " << result.allocations << "}";
+
+    if (SolveProfile::isEnabled())
+    {
+      out << ", \"profile\": {";
+
+      for (std::size_t j = 0; j < SolveProfile::PHASE_COUNT; ++j)
+      {
+        out << "\"" << SolveProfile::getName(static_cast<SolveProfile::Phase>(j)) << "\": {\"duration\": " << milliseconds(result.profile.duration[j])
+            << ", \"calls\": " << result.profile.calls[j] << ", \"queries\": " << result.profile.queries[j] << "}, ";
+      }
+
+      out << "\"connect_steps\": " << result.profile.connectSteps << ", \"exhausted_skips\": " << result.profile.exhaustedSkips << "}";
+    }
+
+    if (trials[i].counters.valid)
+    {
+      out << ", \"counters\": {";
+
+      for (std::size_t j = 0; j < PerfCounters::COUNTER_COUNT; ++j)
+      {
+        out << (j > 0 ? ", " : "") << "\"" << PerfCounters::getName(static_cast<PerfCounters::Counter>(j)) << "\": " << trials[i].counters.count[j];
+      }
+
+      out << "}";
+    }
+
+    out << "}";
+  }
+
+  out << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
@@ -0,0 +1,131 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <chrono>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PerfCounters.h"
+#include "Scenario.h"
+#include "TutorialPlanSystem.h"
+
+//  A planner setup: RrtConConBase, or YourPlanner with some of its use_* flags changed
+struct BenchmarkConfiguration
+{
+  std::string name;
+  bool reference; //plan with RrtConConBase, flags are ignored
+  std::vector< std::pair<std::string, bool> > flags; //applied on top of the defaults of YourPlanner
+};
+
+//  Outcome of one seeded run
+struct BenchmarkTrial
+{
+  std::string scenario;
+  std::string query;
+  ScenarioQuery::Difficulty difficulty;
+  std::string configuration;
+  std::size_t trial;
+  std::mt19937::result_type seed;
+  PlanResult result;
+  PerfCounters::Values counters; //hardware counters over the same section as result.duration, invalid without Benchmark::perfCounters
+};
+
+//  Trials of one configuration on one query, times are of the solved trials only
+struct BenchmarkStatistics
+{
+  std::string scenario;
+  std::string query;
+  ScenarioQuery::Difficulty difficulty;
+  std::string configuration;
+  std::size_t trials;
+  std::size_t solved;
+  double solveRate;
+  double median; //[ms]
+  double p90; //[ms]
+  double p99; //[ms]
+  double vertices; //median over all trials
+  double totalQueries; //median over all trials
+  double freeQueries; //median over all trials
+  double treeBytes; //estimated for glibc malloc, median over all trials
+  double vertexBytes; //estimated for glibc malloc, median over all trials
+  double peakBytes; //median over all trials, 0 without AllocationHooks.cpp
+  double allocations; //median over all trials, 0 without AllocationHooks.cpp
+  std::size_t counted; //trials with hardware counters, the counter statistics are medians over them
+  double cycles;
+  double instructions;
+  double ipc; //instructions per cycle
+  double cacheMpki; //cache misses per thousand instructions
+  double branchMpki; //branch misses per thousand instructions
+};
+
+//  Runs every planner configuration for a number of seeded trials on every query of a scenario.
+//  Trial i of every configuration uses the same seed, so the configurations see the same random numbers
+//  as far as they draw them in the same order.
+class Benchmark
+{
+public:
+  //  system has to be loaded with the scene and kinematics of the scenarios that are run
+  Benchmark(TutorialPlanSystem& system);
+  virtual ~Benchmark();
+
+  //  RrtConConBase, YourPlanner as constructed, YourPlanner without any flag, and YourPlanner with one flag each
+  static std::vector<BenchmarkConfiguration> defaultConfigurations();
+
+  //  Build type and tuning the planners were compiled with, e.g. Release+NATIVE+LTO+PGO_USE
+  static const char* getBuild();
+
+  //  Names of the use_* flags a configuration may set
+  static const std::vector<std::string>& flagNames();
+
+  //  The use_* member of planner called name, NULL if there is none
+  static bool* flag(YourPlanner& planner, const std::string& name);
+
+  std::vector<BenchmarkTrial> run(const Scenario& scenario, const std::vector<BenchmarkConfiguration>& configurations, std::size_t trials);
+
+  //  One entry per query and configuration, in the order of the trials
+  static std::vector<BenchmarkStatistics> summarize(const std::vector<BenchmarkTrial>& trials);
+
+  //  One CSV line per trial: scenario, query, difficulty, configuration, trial, seed, solved, duration [ms], vertices, collision queries, free queries, length,
+  //  estimated bytes of all trees, the start tree and the goal tree, estimated bytes per vertex (est_*, glibc malloc assumed), peak heap growth [bytes], allocator calls,
+  //  with TUTORIAL_PLAN_PROFILE duration [ms], calls and collision queries per phase of solve(), connect steps and exhausted skips,
+  //  and if any trial was counted cycles, instructions, cache misses and branch misses
+  static void writeTrials(std::ostream& out, const std::vector<BenchmarkTrial>& trials);
+
+  //  Reads trials written by writeTrials(), columns are found by their header, so extra columns are skipped,
+  //  the tree bytes are also found under their names without est_ of older files.
+  //  The profile and the hardware counters are not restored, false if a column is missing or a line cannot be read.
+  static bool readTrials(std::istream& in, std::vector<BenchmarkTrial>& trials);
+
+  //  One CSV line per query and configuration, with the counter statistics if any trial was counted
+  static void writeStatistics(std::ostream& out, const std::vector<BenchmarkStatistics>& statistics);
+
+  //  Build, trials and statistics as one JSON object
+  static void writeJson(std::ostream& out, const std::vector<BenchmarkTrial>& trials, const std::vector<BenchmarkStatistics>& statistics);
+
+  //  Seed of the first trial, trial i is seeded with seed + i
+  std::mt19937::result_type seed;
+
+  //  Time limit of the planner per trial
+  std::chrono::steady_clock::duration timeout;
+
+  //  Called after every trial, e.g. to report progress
+  std::function<void(const BenchmarkTrial&)> onTrial;
+
+  //  Read around the planner of every trial if open, opened by the caller on the thread that runs the trials, NULL for none
+  PerfCounters* perfCounters;
+
+private:
+  void configure(const BenchmarkConfiguration& configuration);
+
+  TutorialPlanSystem& system;
+
+  //  Flags of YourPlanner before the first configuration was applied
+  std::vector< std::pair<std::string, bool> > defaults;
+};
+
+#endif
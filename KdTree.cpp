@@ -0,0 +1,124 @@
+#include "KdTree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  bool
+  closer(const KdTree::Neighbor& lhs, const KdTree::Neighbor& rhs)
+  {
+    return lhs.second < rhs.second;
+  }
+}
+
+KdTree::KdTree() :
+  nodes()
+{
+}
+
+KdTree::~KdTree()
+{
+}
+
+void
+KdTree::clear()
+{
+  this->nodes.clear();
+}
+
+void
+KdTree::insert(const ::rl::math::Vector& q, const ::std::size_t& id)
+{
+  Node node;
+  node.q = q;
+  node.id = id;
+  node.axis = 0;
+  node.left = 0;
+  node.right = 0;
+
+  if (this->nodes.empty())
+  {
+    this->nodes.push_back(node);
+    return;
+  }
+
+  ::std::size_t i = 0;
+
+  while (true)
+  {
+    ::std::size_t& child = q(this->nodes[i].axis) < this->nodes[i].q(this->nodes[i].axis) ? this->nodes[i].left : this->nodes[i].right;
+
+    if (0 == child)
+    {
+      node.axis = (this->nodes[i].axis + 1) % q.size();
+      child = this->nodes.size();
+      this->nodes.push_back(node);
+      return;
+    }
+
+    i = child;
+  }
+}
+
+::std::vector< KdTree::Neighbor >
+KdTree::nearest(const ::rl::math::Vector& q, const ::std::size_t& k) const
+{
+  // Max-heap on squared distance of the best k points so far
+  ::std::vector< Neighbor > heap;
+
+  if (!this->nodes.empty() && k > 0)
+  {
+    heap.reserve(k + 1);
+    this->search(0, q, k, heap);
+  }
+
+  ::std::sort_heap(heap.begin(), heap.end(), closer);
+
+  for (::std::size_t i = 0; i < heap.size(); ++i)
+  {
+    heap[i].second = ::std::sqrt(heap[i].second);
+  }
+
+  return heap;
+}
+
+void
+KdTree::search(const ::std::size_t& node, const ::rl::math::Vector& q, const ::std::size_t& k, ::std::vector< Neighbor >& heap) const
+{
+  const Node& n = this->nodes[node];
+
+  ::rl::math::Real d = (q - n.q).squaredNorm();
+
+  if (heap.size() < k)
+  {
+    heap.push_back(Neighbor(n.id, d));
+    ::std::push_heap(heap.begin(), heap.end(), closer);
+  }
+  else if (d < heap.front().second)
+  {
+    ::std::pop_heap(heap.begin(), heap.end(), closer);
+    heap.back() = Neighbor(n.id, d);
+    ::std::push_heap(heap.begin(), heap.end(), closer);
+  }
+
+  ::rl::math::Real diff = q(n.axis) - n.q(n.axis);
+  ::std::size_t near = diff < 0 ? n.left : n.right;
+  ::std::size_t far = diff < 0 ? n.right : n.left;
+
+  if (0 != near)
+  {
+    this->search(near, q, k, heap);
+  }
+
+  // The other side can only contain closer points if the splitting plane is closer than the worst one
+  if (0 != far && (heap.size() < k || diff * diff < heap.front().second))
+  {
+    this->search(far, q, k, heap);
+  }
+}
+
+::std::size_t
+KdTree::size() const
+{
+  return this->nodes.size();
+}
@@ -0,0 +1,54 @@
+#ifndef _KD_TREE_H_
+#define _KD_TREE_H_
+
+#include <utility>
+#include <vector>
+#include <rl/math/Vector.h>
+
+/**
+*	Incremental k-d tree over joint space configurations.
+*	Points are inserted one by one without rebalancing, which keeps insertion cheap
+*	and works well for uniformly distributed samples. Distances are Euclidean, which
+*	is what rl::plan::Model::distance computes for robots with revolute joints.
+*/
+class KdTree
+{
+public:
+  /** Id of a point and its distance to the query */
+  typedef ::std::pair< ::std::size_t, ::rl::math::Real > Neighbor;
+
+  KdTree();
+
+  virtual ~KdTree();
+
+  void insert(const ::rl::math::Vector& q, const ::std::size_t& id);
+
+  /** The k points closest to q, sorted by distance */
+  ::std::vector< Neighbor > nearest(const ::rl::math::Vector& q, const ::std::size_t& k) const;
+
+  void clear();
+
+  ::std::size_t size() const;
+
+private:
+  struct Node
+  {
+    ::rl::math::Vector q;
+
+    ::std::size_t id;
+
+    /** Splitting dimension */
+    ::std::size_t axis;
+
+    /** Children, 0 if there is none (the root is never a child) */
+    ::std::size_t left;
+
+    ::std::size_t right;
+  };
+
+  void search(const ::std::size_t& node, const ::rl::math::Vector& q, const ::std::size_t& k, ::std::vector< Neighbor >& heap) const;
+
+  ::std::vector< Node > nodes;
+};
+
+#endif // _KD_TREE_H_
@@ -0,0 +1,179 @@
+#include "MappedFile.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+  begin(NULL),
+  length(0),
+  buffer()
+{
+}
+
+MappedFile::~MappedFile()
+{
+  this->close();
+}
+
+bool
+MappedFile::open(const ::std::string& filename)
+{
+  this->close();
+
+#ifndef _WIN32
+  int fd = ::open(filename.c_str(), O_RDONLY);
+
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat status;
+
+  if (::fstat(fd, &status) != 0 || status.st_size <= 0)
+  {
+    ::close(fd);
+    return false;
+  }
+
+  void* mapped = ::mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping keeps its own reference to the file
+  ::close(fd);
+
+  if (MAP_FAILED == mapped)
+  {
+    return false;
+  }
+
+  this->begin = static_cast< const char* >(mapped);
+  this->length = status.st_size;
+#else
+  ::std::ifstream file(filename.c_str(), ::std::ios::binary);
+
+  if (!file)
+  {
+    return false;
+  }
+
+  this->buffer.assign(::std::istreambuf_iterator< char >(file), ::std::istreambuf_iterator< char >());
+
+  if (this->buffer.empty())
+  {
+    return false;
+  }
+
+  this->begin = this->buffer.data();
+  this->length = this->buffer.size();
+#endif
+
+  return true;
+}
+
+void
+MappedFile::close()
+{
+#ifndef _WIN32
+  if (NULL != this->begin)
+  {
+    ::munmap(const_cast< char* >(this->begin), this->length);
+  }
+#endif
+
+  this->buffer.clear();
+  this->begin = NULL;
+  this->length = 0;
+}
+
+const char*
+MappedFile::data() const
+{
+  return this->begin;
+}
+
+::std::size_t
+MappedFile::size() const
+{
+  return this->length;
+}
+
+bool
+MappedFile::isOpen() const
+{
+  return NULL != this->begin;
+}
+
+::std::uint64_t
+fingerprintFiles(const ::std::vector< ::std::string >& filenames)
+{
+  ::std::uint64_t hash = 14695981039346656037ULL;
+
+  // Files still to hash in order, referenced ones are hashed right after the file referencing them
+  ::std::vector< ::std::string > pending(filenames.rbegin(), filenames.rend());
+  ::std::set< ::std::string > visited;
+
+  while (!pending.empty())
+  {
+    ::std::string filename = pending.back();
+    pending.pop_back();
+
+    if (!visited.insert(filename).second)
+    {
+      continue;
+    }
+
+    ::std::ifstream file(filename.c_str(), ::std::ios::binary);
+    ::std::string contents((::std::istreambuf_iterator< char >(file)), ::std::istreambuf_iterator< char >());
+
+    for (::std::size_t i = 0; i < contents.size(); ++i)
+    {
+      hash ^= static_cast< unsigned char >(contents[i]);
+      hash *= 1099511628211ULL;
+    }
+
+    // Separator, so moving bytes between files changes the hash
+    hash ^= 0xff;
+    hash *= 1099511628211ULL;
+
+    // Geometry is referenced by href attributes of the scene XML and by url fields of VRML Inline nodes,
+    // relative to the referencing file
+    ::std::string directory = filename.substr(0, filename.find_last_of("/\\") + 1);
+    ::std::vector< ::std::string > references;
+    const char* keys[] = {"href=\"", "url \""};
+
+    for (::std::size_t k = 0; k < 2; ++k)
+    {
+      ::std::size_t length = ::std::strlen(keys[k]);
+
+      for (::std::size_t begin = contents.find(keys[k]); ::std::string::npos != begin; begin = contents.find(keys[k], begin))
+      {
+        begin += length;
+        ::std::size_t end = contents.find('"', begin);
+
+        if (::std::string::npos == end)
+        {
+          break;
+        }
+
+        ::std::string reference = contents.substr(begin, end - begin);
+
+        if (!reference.empty() && ::std::string::npos == reference.find("://"))
+        {
+          references.push_back('/' == reference[0] ? reference : directory + reference);
+        }
+      }
+    }
+
+    pending.insert(pending.end(), references.rbegin(), references.rend());
+  }
+
+  return hash;
+}
@@ -0,0 +1,51 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+*	Read-only view of a whole file, memory-mapped where the platform supports it.
+*	The data stays valid until the object is closed or destroyed, even if the
+*	file is replaced on disk in the meantime.
+*/
+class MappedFile
+{
+public:
+  MappedFile();
+
+  virtual ~MappedFile();
+
+  /** Maps filename, returns false if it does not exist or cannot be read */
+  bool open(const ::std::string& filename);
+
+  void close();
+
+  const char* data() const;
+
+  ::std::size_t size() const;
+
+  bool isOpen() const;
+
+private:
+  MappedFile(const MappedFile&);
+
+  MappedFile& operator=(const MappedFile&);
+
+  const char* begin;
+
+  ::std::size_t length;
+
+  /** Fallback storage on platforms without mmap */
+  ::std::vector< char > buffer;
+};
+
+/**
+*	FNV-1a hash over the contents of the given files and the geometry files they reference,
+*	used to tie cached data to a scene and kinematics.
+*/
+::std::uint64_t fingerprintFiles(const ::std::vector< ::std::string >& filenames);
+
+#endif // _MAPPED_FILE_H_
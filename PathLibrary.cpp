@@ -0,0 +1,223 @@
+#include "PathLibrary.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "MappedFile.h"
+
+namespace
+{
+  const char libraryMagic[8] = {'R', 'L', 'P', 'A', 'T', 'H', 'S', '\0'};
+
+  const ::std::uint32_t libraryVersion = 1;
+
+  /** File layout: Header, numPaths + 1 offsets into the configurations, then all configurations as packed dof reals */
+  struct Header
+  {
+    char magic[8];
+
+    ::std::uint32_t version;
+
+    ::std::uint32_t realSize;
+
+    ::std::uint64_t dof;
+
+    ::std::uint64_t fingerprint;
+
+    ::std::uint64_t numPaths;
+
+    ::std::uint64_t numConfigurations;
+  };
+}
+
+PathLibrary::PathLibrary() :
+  capacity(10000),
+  epsilon(1.0e-3f),
+  index(),
+  paths()
+{
+}
+
+PathLibrary::~PathLibrary()
+{
+}
+
+void
+PathLibrary::add(const ::rl::plan::VectorList& path)
+{
+  if (path.size() < 2)
+  {
+    return;
+  }
+
+  ::rl::math::Vector k = key(path.front(), path.back());
+  ::std::vector< KdTree::Neighbor > neighbors = this->index.nearest(k, 1);
+
+  if (!neighbors.empty() && neighbors.front().second <= this->epsilon)
+  {
+    if (length(path) < length(this->paths[neighbors.front().first]))
+    {
+      this->paths[neighbors.front().first] = path;
+    }
+
+    return;
+  }
+
+  if (this->paths.size() >= this->capacity)
+  {
+    return;
+  }
+
+  this->index.insert(k, this->paths.size());
+  this->paths.push_back(path);
+}
+
+void
+PathLibrary::clear()
+{
+  this->index.clear();
+  this->paths.clear();
+}
+
+::rl::math::Vector
+PathLibrary::key(const ::rl::math::Vector& start, const ::rl::math::Vector& goal)
+{
+  ::rl::math::Vector k(start.size() + goal.size());
+  k << start, goal;
+  return k;
+}
+
+::rl::math::Real
+PathLibrary::length(const ::rl::plan::VectorList& path)
+{
+  ::rl::math::Real length = 0;
+  ::rl::plan::VectorList::const_iterator i = path.begin();
+
+  for (::rl::plan::VectorList::const_iterator j = ++path.begin(); j != path.end(); ++i, ++j)
+  {
+    length += (*j - *i).norm();
+  }
+
+  return length;
+}
+
+bool
+PathLibrary::load(const ::std::string& filename, const ::std::uint64_t& fingerprint)
+{
+  MappedFile file;
+
+  if (!file.open(filename) || file.size() < sizeof(Header))
+  {
+    return false;
+  }
+
+  Header header;
+  ::std::memcpy(&header, file.data(), sizeof(Header));
+
+  ::std::size_t dof = header.dof;
+
+  if (0 != ::std::memcmp(header.magic, libraryMagic, sizeof(libraryMagic)) ||
+      header.version != libraryVersion ||
+      header.realSize != sizeof(::rl::math::Real) ||
+      header.fingerprint != fingerprint ||
+      file.size() != sizeof(Header) + (header.numPaths + 1) * sizeof(::std::uint64_t) + header.numConfigurations * dof * sizeof(::rl::math::Real))
+  {
+    return false;
+  }
+
+  const ::std::uint64_t* offsets = reinterpret_cast< const ::std::uint64_t* >(file.data() + sizeof(Header));
+  const ::rl::math::Real* q = reinterpret_cast< const ::rl::math::Real* >(offsets + header.numPaths + 1);
+
+  this->clear();
+
+  for (::std::size_t i = 0; i < header.numPaths; ++i)
+  {
+    ::rl::plan::VectorList path;
+
+    for (::std::uint64_t j = offsets[i]; j < offsets[i + 1] && j < header.numConfigurations; ++j)
+    {
+      path.push_back(::Eigen::Map< const ::rl::math::Vector >(q + j * dof, dof));
+    }
+
+    this->add(path);
+  }
+
+  return true;
+}
+
+bool
+PathLibrary::nearest(const ::rl::math::Vector& start, const ::rl::math::Vector& goal, ::rl::plan::VectorList& path, ::rl::math::Real& distance) const
+{
+  ::std::vector< KdTree::Neighbor > neighbors = this->index.nearest(key(start, goal), 1);
+
+  if (neighbors.empty())
+  {
+    return false;
+  }
+
+  path = this->paths[neighbors.front().first];
+  distance = neighbors.front().second;
+
+  return true;
+}
+
+bool
+PathLibrary::save(const ::std::string& filename, const ::std::uint64_t& fingerprint) const
+{
+  Header header;
+  ::std::memcpy(header.magic, libraryMagic, sizeof(libraryMagic));
+  header.version = libraryVersion;
+  header.realSize = sizeof(::rl::math::Real);
+  header.dof = this->paths.empty() ? 0 : this->paths.front().front().size();
+  header.fingerprint = fingerprint;
+  header.numPaths = this->paths.size();
+  header.numConfigurations = 0;
+
+  ::std::vector< ::std::uint64_t > offsets(1, 0);
+
+  for (::std::size_t i = 0; i < this->paths.size(); ++i)
+  {
+    header.numConfigurations += this->paths[i].size();
+    offsets.push_back(header.numConfigurations);
+  }
+
+  ::std::string tmp = filename + ".tmp";
+  ::std::ofstream out(tmp.c_str(), ::std::ios::binary | ::std::ios::trunc);
+
+  if (!out)
+  {
+    return false;
+  }
+
+  out.write(reinterpret_cast< const char* >(&header), sizeof(Header));
+  out.write(reinterpret_cast< const char* >(offsets.data()), offsets.size() * sizeof(::std::uint64_t));
+
+  for (::std::size_t i = 0; i < this->paths.size(); ++i)
+  {
+    for (::rl::plan::VectorList::const_iterator j = this->paths[i].begin(); j != this->paths[i].end(); ++j)
+    {
+      out.write(reinterpret_cast< const char* >(j->data()), j->size() * sizeof(::rl::math::Real));
+    }
+  }
+
+  out.close();
+
+  if (!out)
+  {
+    ::std::remove(tmp.c_str());
+    return false;
+  }
+
+#ifdef _WIN32
+  // rename does not replace existing files on windows
+  ::std::remove(filename.c_str());
+#endif
+
+  return 0 == ::std::rename(tmp.c_str(), filename.c_str());
+}
+
+::std::size_t
+PathLibrary::size() const
+{
+  return this->paths.size();
+}
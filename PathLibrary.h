@@ -0,0 +1,55 @@
+#ifndef _PATH_LIBRARY_H_
+#define _PATH_LIBRARY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <rl/plan/VectorList.h>
+
+#include "KdTree.h"
+
+/**
+*	Library of solved paths for experience-based planning.
+*	Paths are indexed by their concatenated start and goal configuration, so the
+*	stored path of the most similar query can be retrieved and repaired instead
+*	of planning from scratch.
+*/
+class PathLibrary
+{
+public:
+  PathLibrary();
+
+  virtual ~PathLibrary();
+
+  /** Stores path under its first and last configuration, replaces a longer path stored for the same query */
+  void add(const ::rl::plan::VectorList& path);
+
+  /** Retrieves the path whose start and goal are closest to the query, distance is measured in the joined 2 * dof space */
+  bool nearest(const ::rl::math::Vector& start, const ::rl::math::Vector& goal, ::rl::plan::VectorList& path, ::rl::math::Real& distance) const;
+
+  bool save(const ::std::string& filename, const ::std::uint64_t& fingerprint) const;
+
+  /** Replaces the library with the one in filename, fails if it was written for another scene, robot or build */
+  bool load(const ::std::string& filename, const ::std::uint64_t& fingerprint);
+
+  void clear();
+
+  ::std::size_t size() const;
+
+  /** Paths that are kept at most */
+  ::std::size_t capacity;
+
+  /** Queries closer than this are considered the same */
+  ::rl::math::Real epsilon;
+
+private:
+  static ::rl::math::Vector key(const ::rl::math::Vector& start, const ::rl::math::Vector& goal);
+
+  static ::rl::math::Real length(const ::rl::plan::VectorList& path);
+
+  KdTree index;
+
+  ::std::vector< ::rl::plan::VectorList > paths;
+};
+
+#endif // _PATH_LIBRARY_H_
@@ -0,0 +1,182 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PerfCounters::Values::Values() :
+  valid(false)
+{
+  for (::std::size_t i = 0; i < COUNTER_COUNT; ++i)
+  {
+    this->count[i] = 0;
+  }
+}
+
+double
+PerfCounters::Values::getIpc() const
+{
+  if (!this->valid || 0 == this->count[COUNTER_CYCLES])
+  {
+    return ::std::numeric_limits<double>::quiet_NaN();
+  }
+
+  return static_cast<double>(this->count[COUNTER_INSTRUCTIONS]) / this->count[COUNTER_CYCLES];
+}
+
+double
+PerfCounters::Values::getMpki(const Counter& counter) const
+{
+  if (!this->valid || 0 == this->count[COUNTER_INSTRUCTIONS])
+  {
+    return ::std::numeric_limits<double>::quiet_NaN();
+  }
+
+  return 1000.0 * this->count[counter] / this->count[COUNTER_INSTRUCTIONS];
+}
+
+const char*
+PerfCounters::getName(const Counter& counter)
+{
+  switch (counter)
+  {
+  case COUNTER_CYCLES:
+    return "cycles";
+  case COUNTER_INSTRUCTIONS:
+    return "instructions";
+  case COUNTER_CACHE_MISSES:
+    return "cache_misses";
+  case COUNTER_BRANCH_MISSES:
+    return "branch_misses";
+  default:
+    return "";
+  }
+}
+
+PerfCounters::PerfCounters()
+{
+  for (::std::size_t i = 0; i < COUNTER_COUNT; ++i)
+  {
+    this->fd[i] = -1;
+  }
+}
+
+PerfCounters::~PerfCounters()
+{
+  this->close();
+}
+
+bool
+PerfCounters::open()
+{
+  this->close();
+
+#ifdef __linux__
+  const ::std::uint64_t configs[COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  for (::std::size_t i = 0; i < COUNTER_COUNT; ++i)
+  {
+    struct perf_event_attr attr;
+    ::std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = configs[i];
+    attr.disabled = 0 == i ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    this->fd[i] = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, 0 == i ? -1 : this->fd[0], 0));
+
+    if (this->fd[i] < 0)
+    {
+      this->close();
+      return false;
+    }
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+PerfCounters::close()
+{
+#ifdef __linux__
+  for (::std::size_t i = 0; i < COUNTER_COUNT; ++i)
+  {
+    if (this->fd[i] >= 0)
+    {
+      ::close(this->fd[i]);
+    }
+
+    this->fd[i] = -1;
+  }
+#endif
+}
+
+bool
+PerfCounters::isOpen() const
+{
+  return this->fd[0] >= 0;
+}
+
+void
+PerfCounters::start()
+{
+#ifdef __linux__
+  if (this->isOpen())
+  {
+    ::ioctl(this->fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(this->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+}
+
+PerfCounters::Values
+PerfCounters::stop()
+{
+  Values values;
+
+#ifdef __linux__
+  if (!this->isOpen())
+  {
+    return values;
+  }
+
+  ::ioctl(this->fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+  // Group read: number of counters, time enabled, time running, then one value per counter
+  ::std::uint64_t buffer[3 + COUNTER_COUNT];
+
+  if (::read(this->fd[0], buffer, sizeof(buffer)) != static_cast< ::ssize_t >(sizeof(buffer)) || COUNTER_COUNT != buffer[0] || 0 == buffer[2])
+  {
+    return values;
+  }
+
+  double scale = static_cast<double>(buffer[1]) / buffer[2];
+
+  for (::std::size_t i = 0; i < COUNTER_COUNT; ++i)
+  {
+    values.count[i] = static_cast< ::std::uint64_t >(::std::llround(buffer[3 + i] * scale));
+  }
+
+  values.valid = true;
+#endif
+
+  return values;
+}
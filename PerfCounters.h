@@ -0,0 +1,64 @@
+#ifndef _PERF_COUNTERS_H_
+#define _PERF_COUNTERS_H_
+
+#include <cstdint>
+
+/**
+*	Hardware performance counters of the calling thread: cycles, instructions, cache misses
+*	and branch misses, read with perf_event_open on Linux. Elsewhere, or if the kernel does
+*	not permit it (see /proc/sys/kernel/perf_event_paranoid), open() fails and nothing is counted.
+*/
+class PerfCounters
+{
+public:
+  enum Counter
+  {
+    COUNTER_CYCLES = 0,
+    COUNTER_INSTRUCTIONS = 1,
+    COUNTER_CACHE_MISSES = 2,
+    COUNTER_BRANCH_MISSES = 3,
+    COUNTER_COUNT = 4
+  };
+
+  struct Values
+  {
+    Values();
+
+    /** Instructions per cycle */
+    double getIpc() const;
+
+    /** Misses per thousand instructions */
+    double getMpki(const Counter& counter) const;
+
+    /** Scaled up if the kernel had to multiplex the counters */
+    ::std::uint64_t count[COUNTER_COUNT];
+
+    /** All counters were read */
+    bool valid;
+  };
+
+  static const char* getName(const Counter& counter);
+
+  PerfCounters();
+
+  virtual ~PerfCounters();
+
+  /** Opens the counters for the calling thread, false if they are not available */
+  bool open();
+
+  void close();
+
+  bool isOpen() const;
+
+  /** Resets and enables the counters */
+  void start();
+
+  /** Disables the counters and returns their values since start() */
+  Values stop();
+
+private:
+  /** The first counter leads the group, so all of them count the same instructions */
+  int fd[COUNTER_COUNT];
+};
+
+#endif
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+#include "Regression.h"
+#include "Report.h"
+
+Regression::Regression() :
+  alpha(0.01),
+  threshold(0.1)
+{
+}
+
+Regression::~Regression()
+{
+}
+
+const std::vector<std::string>& Regression::metricNames()
+{
+  static const std::vector<std::string> names = {
+    "duration",
+    "queries",
+    "vertices",
+    "peak_bytes"
+  };
+
+  return names;
+}
+
+double Regression::metric(const BenchmarkTrial& trial, const std::string& name)
+{
+  if ("duration" == name) return trial.result.duration;
+  if ("queries" == name) return trial.result.totalQueries;
+  if ("vertices" == name) return trial.result.vertices;
+  if ("peak_bytes" == name) return trial.result.peakBytes;
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+double Regression::mannWhitney(const std::vector<double>& baseline, const std::vector<double>& current, double& u)
+{
+  //  Values of both samples in ascending order, second is true for the current ones
+  std::vector< std::pair<double, bool> > values;
+
+  for (std::size_t i = 0; i < baseline.size(); ++i)
+  {
+    values.push_back(std::make_pair(baseline[i], false));
+  }
+
+  for (std::size_t i = 0; i < current.size(); ++i)
+  {
+    values.push_back(std::make_pair(current[i], true));
+  }
+
+  std::sort(values.begin(), values.end());
+
+  //  Tied values share the mean of their ranks
+  double rankSum = 0;
+  double ties = 0;
+
+  for (std::size_t begin = 0; begin < values.size();)
+  {
+    std::size_t end = begin;
+
+    while (end < values.size() && values[end].first == values[begin].first)
+    {
+      ++end;
+    }
+
+    double rank = (begin + 1 + end) / 2.0;
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      rankSum += values[i].second ? rank : 0;
+    }
+
+    double t = static_cast<double>(end - begin);
+    ties += t * t * t - t;
+    begin = end;
+  }
+
+  double m = static_cast<double>(baseline.size());
+  double n = static_cast<double>(current.size());
+  double total = m + n;
+
+  u = rankSum - n * (n + 1) / 2;
+
+  if (0 == m || 0 == n)
+  {
+    return 1;
+  }
+
+  double variance = m * n / 12 * ((total + 1) - ties / (total * (total - 1)));
+
+  if (variance <= 0)
+  {
+    return 1;
+  }
+
+  double z = (u - m * n / 2 - 0.5) / std::sqrt(variance);
+
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+std::vector<RegressionComparison> Regression::compare(const std::vector<BenchmarkTrial>& baseline, const std::vector<BenchmarkTrial>& current) const
+{
+  //  Trials of both runs grouped by scenario, query and configuration, in the order of the current run
+  typedef std::pair< std::pair<std::string, std::string>, std::string > Key;
+  std::map< Key, std::vector<const BenchmarkTrial*> > stored;
+
+  for (std::size_t i = 0; i < baseline.size(); ++i)
+  {
+    stored[Key(std::make_pair(baseline[i].scenario, baseline[i].query), baseline[i].configuration)].push_back(&baseline[i]);
+  }
+
+  std::vector<Key> order;
+  std::map< Key, std::vector<const BenchmarkTrial*> > measured;
+
+  for (std::size_t i = 0; i < current.size(); ++i)
+  {
+    Key key(std::make_pair(current[i].scenario, current[i].query), current[i].configuration);
+
+    if (measured.end() == measured.find(key))
+    {
+      order.push_back(key);
+    }
+
+    measured[key].push_back(&current[i]);
+  }
+
+  const std::vector<std::string>& names = metricNames();
+  std::vector<RegressionComparison> comparisons;
+
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    std::map< Key, std::vector<const BenchmarkTrial*> >::const_iterator before = stored.find(order[i]);
+
+    if (stored.end() == before)
+    {
+      continue;
+    }
+
+    const std::vector<const BenchmarkTrial*>& after = measured[order[i]];
+
+    for (std::size_t j = 0; j < names.size(); ++j)
+    {
+      std::vector<double> baselineValues;
+      std::vector<double> currentValues;
+
+      for (std::size_t k = 0; k < before->second.size(); ++k)
+      {
+        baselineValues.push_back(metric(*before->second[k], names[j]));
+      }
+
+      for (std::size_t k = 0; k < after.size(); ++k)
+      {
+        currentValues.push_back(metric(*after[k], names[j]));
+      }
+
+      if (std::count(baselineValues.begin(), baselineValues.end(), 0.0) == static_cast<std::ptrdiff_t>(baselineValues.size()) ||
+          std::count(currentValues.begin(), currentValues.end(), 0.0) == static_cast<std::ptrdiff_t>(currentValues.size()))
+      {
+        continue;
+      }
+
+      RegressionComparison comparison;
+      comparison.scenario = order[i].first.first;
+      comparison.query = order[i].first.second;
+      comparison.configuration = order[i].second;
+      comparison.metric = names[j];
+      comparison.baselineTrials = baselineValues.size();
+      comparison.currentTrials = currentValues.size();
+      comparison.baselineMedian = median(baselineValues);
+      comparison.currentMedian = median(currentValues);
+      comparison.change = comparison.baselineMedian > 0 ? comparison.currentMedian / comparison.baselineMedian - 1 : (comparison.currentMedian > 0 ? std::numeric_limits<double>::infinity() : 0);
+      comparison.p = mannWhitney(baselineValues, currentValues, comparison.u);
+      comparison.regressed = comparison.p < this->alpha && comparison.change > this->threshold;
+      comparisons.push_back(comparison);
+    }
+  }
+
+  return comparisons;
+}
+
+bool Regression::isRegressed(const std::vector<RegressionComparison>& comparisons)
+{
+  for (std::size_t i = 0; i < comparisons.size(); ++i)
+  {
+    if (comparisons[i].regressed)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+double Regression::speedup(const std::vector<RegressionComparison>& comparisons)
+{
+  double sum = 0;
+  std::size_t count = 0;
+
+  for (std::size_t i = 0; i < comparisons.size(); ++i)
+  {
+    if ("duration" == comparisons[i].metric && comparisons[i].baselineMedian > 0 && comparisons[i].currentMedian > 0)
+    {
+      sum += std::log(comparisons[i].baselineMedian / comparisons[i].currentMedian);
+      ++count;
+    }
+  }
+
+  return count > 0 ? std::exp(sum / count) : std::numeric_limits<double>::quiet_NaN();
+}
+
+void Regression::writeCsv(std::ostream& out, const std::vector<RegressionComparison>& comparisons)
+{
+  out << "scenario,query,configuration,metric,baseline_trials,current_trials,baseline_median,current_median,change,u,p,regressed" << std::endl;
+
+  for (std::size_t i = 0; i < comparisons.size(); ++i)
+  {
+    const RegressionComparison& entry = comparisons[i];
+    out << entry.scenario << "," << entry.query << "," << entry.configuration << "," << entry.metric << ","
+        << entry.baselineTrials << "," << entry.currentTrials << ",";
+    writeNumber(out, entry.baselineMedian, false);
+    out << ",";
+    writeNumber(out, entry.currentMedian, false);
+    out << ",";
+    writeNumber(out, entry.change, false);
+    out << "," << entry.u << "," << entry.p << "," << (entry.regressed ? "true" : "false") << std::endl;
+  }
+}
+
+void Regression::writeJson(std::ostream& out, const std::vector<RegressionComparison>& comparisons)
+{
+  out << "{" << std::endl << "  \"regressed\": " << (isRegressed(comparisons) ? "true" : "false") << "," << std::endl << "  \"speedup\": ";
+  writeNumber(out, speedup(comparisons), true);
+  out << "," << std::endl << "  \"comparisons\": [";
+
+  for (std::size_t i = 0; i < comparisons.size(); ++i)
+  {
+    const RegressionComparison& entry = comparisons[i];
+    out << (i > 0 ? "," : "") << std::endl << "    {\"scenario\": ";
+    writeString(out, entry.scenario);
+    out << ", \"query\": ";
+    writeString(out, entry.query);
+    out << ", \"configuration\": ";
+    writeString(out, entry.configuration);
+    out << ", \"metric\": ";
+    writeString(out, entry.metric);
+    out << ", \"baseline_trials\": " << entry.baselineTrials << ", \"current_trials\": " << entry.currentTrials;
+    out << ", \"baseline_median\": ";
+    writeNumber(out, entry.baselineMedian, true);
+    out << ", \"current_median\": ";
+    writeNumber(out, entry.currentMedian, true);
+    out << ", \"change\": ";
+    writeNumber(out, entry.change, true);
+    out << ", \"u\": " << entry.u << ", \"p\": " << entry.p << ", \"regressed\": " << (entry.regressed ? "true" : "false") << "}";
+  }
+
+  out << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
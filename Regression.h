@@ -0,0 +1,69 @@
+#ifndef _REGRESSION_H_
+#define _REGRESSION_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+//  One metric of one configuration on one query, compared between a baseline and a current run
+struct RegressionComparison
+{
+  std::string scenario;
+  std::string query;
+  std::string configuration;
+  std::string metric;
+  std::size_t baselineTrials;
+  std::size_t currentTrials;
+  double baselineMedian;
+  double currentMedian;
+  double change; //relative change of the median, positive is worse
+  double u; //Mann-Whitney U of the current trials
+  double p; //one-sided p-value that the current trials are larger
+  bool regressed;
+};
+
+//  Compares the trials of a run against stored baseline trials with a one-sided Mann-Whitney U test per
+//  query, configuration and metric. All metrics are costs: time to solution (unsolved trials ran into
+//  the timeout and rank last), collision queries, vertices, and the peak heap growth during planning.
+//  A metric that is 0 in every trial of one of the runs was not measured there and is skipped.
+class Regression
+{
+public:
+  Regression();
+  virtual ~Regression();
+
+  //  Names of the compared metrics
+  static const std::vector<std::string>& metricNames();
+
+  //  The metric called name of a trial
+  static double metric(const BenchmarkTrial& trial, const std::string& name);
+
+  //  U of current and the p-value of current being stochastically larger than baseline,
+  //  normal approximation with tie and continuity correction, p is 1 if every value is tied
+  static double mannWhitney(const std::vector<double>& baseline, const std::vector<double>& current, double& u);
+
+  //  Queries and configurations present in only one of the runs are skipped
+  std::vector<RegressionComparison> compare(const std::vector<BenchmarkTrial>& baseline, const std::vector<BenchmarkTrial>& current) const;
+
+  static bool isRegressed(const std::vector<RegressionComparison>& comparisons);
+
+  //  Geometric mean of baseline over current median time to solution, above 1 if the current run is faster,
+  //  e.g. of an optimized build against a plain one, NaN without comparisons of the time
+  static double speedup(const std::vector<RegressionComparison>& comparisons);
+
+  //  One CSV line per comparison
+  static void writeCsv(std::ostream& out, const std::vector<RegressionComparison>& comparisons);
+
+  //  The verdict, the speedup and all comparisons as one JSON object
+  static void writeJson(std::ostream& out, const std::vector<RegressionComparison>& comparisons);
+
+  //  Significance level of the test
+  double alpha;
+
+  //  Significant changes of the median below this relative increase are tolerated, e.g. timer noise
+  double threshold;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef _REPORT_H_
+#define _REPORT_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//  Helpers shared by the CSV and JSON writers of the benchmark, the regression check and the trace
+
+//  Lower median, NaN if there are no values
+inline double median(std::vector<double> values)
+{
+  if (values.empty())
+  {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  std::sort(values.begin(), values.end());
+  return values[(values.size() - 1) / 2];
+}
+
+//  Undefined values are left empty in CSV and written as null in JSON
+inline void writeNumber(std::ostream& out, double value, bool json)
+{
+  if (std::isnan(value) || std::isinf(value))
+  {
+    out << (json ? "null" : "");
+  }
+  else
+  {
+    out << value;
+  }
+}
+
+//  Quoted JSON string
+inline void writeString(std::ostream& out, const std::string& value)
+{
+  out << '"';
+
+  for (std::size_t i = 0; i < value.size(); ++i)
+  {
+    if ('"' == value[i] || '\\' == value[i])
+    {
+      out << '\\';
+    }
+
+    out << value[i];
+  }
+
+  out << '"';
+}
+
+#endif
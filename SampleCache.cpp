@@ -0,0 +1,151 @@
+#include "SampleCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+const char SampleCache::magic[8] = {'R', 'L', 'S', 'C', 'A', 'C', 'H', 'E'};
+
+SampleCache::SampleCache() :
+  capacity(100000),
+  dof(0),
+  fingerprint(0),
+  file()
+{
+  this->clear();
+}
+
+SampleCache::~SampleCache()
+{
+}
+
+void
+SampleCache::add(const Kind& kind, const ::rl::math::Vector& q)
+{
+  if (static_cast< ::std::size_t >(q.size()) != this->dof || this->size(kind) >= this->capacity)
+  {
+    return;
+  }
+
+  this->added[kind].insert(this->added[kind].end(), q.data(), q.data() + q.size());
+}
+
+void
+SampleCache::clear()
+{
+  this->file.close();
+
+  for (::std::size_t k = 0; k < 2; ++k)
+  {
+    this->mapped[k] = NULL;
+    this->numMapped[k] = 0;
+    this->added[k].clear();
+  }
+}
+
+void
+SampleCache::get(const Kind& kind, const ::std::size_t& i, ::rl::math::Vector& q) const
+{
+  q.resize(this->dof);
+
+  const ::rl::math::Real* sample = i < this->numMapped[kind] ?
+    this->mapped[kind] + i * this->dof :
+    this->added[kind].data() + (i - this->numMapped[kind]) * this->dof;
+
+  ::std::copy(sample, sample + this->dof, q.data());
+}
+
+bool
+SampleCache::load(const ::std::string& filename, const ::std::uint64_t& fingerprint, const ::std::size_t& dof)
+{
+  this->clear();
+  this->dof = dof;
+  this->fingerprint = fingerprint;
+
+  if (!this->file.open(filename) || this->file.size() < sizeof(Header))
+  {
+    this->file.close();
+    return false;
+  }
+
+  Header header;
+  ::std::memcpy(&header, this->file.data(), sizeof(Header));
+
+  if (0 != ::std::memcmp(header.magic, magic, sizeof(magic)) ||
+      header.version != version ||
+      header.realSize != sizeof(::rl::math::Real) ||
+      header.dof != dof ||
+      header.fingerprint != fingerprint ||
+      this->file.size() != sizeof(Header) + (header.count[0] + header.count[1]) * dof * sizeof(::rl::math::Real))
+  {
+    // Written for another scene, robot or build, start with an empty cache
+    this->file.close();
+    return false;
+  }
+
+  // Header is a multiple of 8 bytes and mmap is page aligned, so the reals are aligned
+  const ::rl::math::Real* samples = reinterpret_cast< const ::rl::math::Real* >(this->file.data() + sizeof(Header));
+
+  this->mapped[KIND_FREE] = samples;
+  this->numMapped[KIND_FREE] = header.count[KIND_FREE];
+  this->mapped[KIND_BOUNDARY] = samples + header.count[KIND_FREE] * dof;
+  this->numMapped[KIND_BOUNDARY] = header.count[KIND_BOUNDARY];
+
+  return true;
+}
+
+bool
+SampleCache::save(const ::std::string& filename) const
+{
+  Header header;
+  ::std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.realSize = sizeof(::rl::math::Real);
+  header.dof = this->dof;
+  header.fingerprint = this->fingerprint;
+  header.count[KIND_FREE] = this->size(KIND_FREE);
+  header.count[KIND_BOUNDARY] = this->size(KIND_BOUNDARY);
+
+  // Write next to the target and rename, the old file may still be mapped by us or another process
+  ::std::string tmp = filename + ".tmp";
+  ::std::ofstream out(tmp.c_str(), ::std::ios::binary | ::std::ios::trunc);
+
+  if (!out)
+  {
+    return false;
+  }
+
+  out.write(reinterpret_cast< const char* >(&header), sizeof(Header));
+
+  for (::std::size_t k = 0; k < 2; ++k)
+  {
+    out.write(reinterpret_cast< const char* >(this->mapped[k]), this->numMapped[k] * this->dof * sizeof(::rl::math::Real));
+    out.write(reinterpret_cast< const char* >(this->added[k].data()), this->added[k].size() * sizeof(::rl::math::Real));
+  }
+
+  out.close();
+
+  if (!out)
+  {
+    ::std::remove(tmp.c_str());
+    return false;
+  }
+
+#ifdef _WIN32
+  // rename does not replace existing files on windows
+  ::std::remove(filename.c_str());
+#endif
+
+  return 0 == ::std::rename(tmp.c_str(), filename.c_str());
+}
+
+::std::size_t
+SampleCache::size(const Kind& kind) const
+{
+  return this->numMapped[kind] + (0 == this->dof ? 0 : this->added[kind].size() / this->dof);
+}
+
+::std::size_t
+SampleCache::sizeLoaded(const Kind& kind) const
+{
+  return this->numMapped[kind];
+}
@@ -0,0 +1,90 @@
+#ifndef _SAMPLE_CACHE_H_
+#define _SAMPLE_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <rl/math/Vector.h>
+
+#include "MappedFile.h"
+
+/**
+*	Persistent store of configurations the samplers had to find by rejection sampling.
+*	For a static scene these stay valid across runs, so they are written to a binary
+*	file and memory-mapped on the next start. Samples found during a run are appended
+*	in memory and written back by save().
+*
+*	File layout: Header, then count[KIND_FREE] * dof reals, then count[KIND_BOUNDARY] * dof reals.
+*/
+class SampleCache
+{
+public:
+  enum Kind
+  {
+    /** Collision free configurations between obstacles, i.e. bridge sampler results */
+    KIND_FREE = 0,
+    /** Configurations close to an obstacle, i.e. gaussian sampler results */
+    KIND_BOUNDARY = 1
+  };
+
+  SampleCache();
+
+  virtual ~SampleCache();
+
+  /** Maps filename, ignores it if it was written for a different scene or dof */
+  bool load(const ::std::string& filename, const ::std::uint64_t& fingerprint, const ::std::size_t& dof);
+
+  /** Writes mapped and added samples to filename, replacing it atomically */
+  bool save(const ::std::string& filename) const;
+
+  void add(const Kind& kind, const ::rl::math::Vector& q);
+
+  /** Copies sample i of kind into q, mapped samples come first */
+  void get(const Kind& kind, const ::std::size_t& i, ::rl::math::Vector& q) const;
+
+  ::std::size_t size(const Kind& kind) const;
+
+  /** Number of samples of kind loaded from the file, these come first */
+  ::std::size_t sizeLoaded(const Kind& kind) const;
+
+  /** Drops all samples and unmaps the file */
+  void clear();
+
+  /** Samples per kind that are kept at most */
+  ::std::size_t capacity;
+
+  ::std::size_t dof;
+
+  ::std::uint64_t fingerprint;
+
+protected:
+  struct Header
+  {
+    char magic[8];
+
+    ::std::uint32_t version;
+
+    ::std::uint32_t realSize;
+
+    ::std::uint64_t dof;
+
+    ::std::uint64_t fingerprint;
+
+    ::std::uint64_t count[2];
+  };
+
+  static const char magic[8];
+
+  static const ::std::uint32_t version = 1;
+
+private:
+  MappedFile file;
+
+  const ::rl::math::Real* mapped[2];
+
+  ::std::size_t numMapped[2];
+
+  ::std::vector< ::rl::math::Real > added[2];
+};
+
+#endif // _SAMPLE_CACHE_H_
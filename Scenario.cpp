@@ -0,0 +1,231 @@
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include "Scenario.h"
+#include "TutorialPlanSystem.h"
+#include "rl/math/Unit.h"
+
+namespace
+{
+  std::string resolve(const std::string& filename, const std::string& path)
+  {
+    std::string::size_type slash = filename.find_last_of('/');
+
+    if (path.empty() || '/' == path[0] || std::string::npos == slash)
+    {
+      return path;
+    }
+
+    return filename.substr(0, slash + 1) + path;
+  }
+}
+
+const char* ScenarioQuery::getName(Difficulty difficulty)
+{
+  switch (difficulty)
+  {
+  case DIFFICULTY_EASY:
+    return "easy";
+  case DIFFICULTY_MEDIUM:
+    return "medium";
+  default:
+    return "narrow";
+  }
+}
+
+bool ScenarioQuery::parse(const std::string& name, Difficulty& difficulty)
+{
+  if ("easy" == name)
+  {
+    difficulty = DIFFICULTY_EASY;
+  }
+  else if ("medium" == name)
+  {
+    difficulty = DIFFICULTY_MEDIUM;
+  }
+  else if ("narrow" == name)
+  {
+    difficulty = DIFFICULTY_NARROW;
+  }
+  else
+  {
+    return false;
+  }
+
+  return true;
+}
+
+Scenario::Scenario() :
+  name(),
+  sceneFile(),
+  kinematicsFile(),
+  seed(1),
+  queries(),
+  pending()
+{
+}
+
+Scenario::~Scenario()
+{
+}
+
+bool Scenario::load(const std::string& filename)
+{
+  std::ifstream file(filename.c_str());
+
+  if (!file)
+  {
+    return false;
+  }
+
+  std::string line;
+
+  while (std::getline(file, line))
+  {
+    std::istringstream values(line.substr(0, line.find('#')));
+    std::string key;
+
+    if (!(values >> key))
+    {
+      continue;
+    }
+
+    if ("name" == key)
+    {
+      values >> this->name;
+    }
+    else if ("scene" == key)
+    {
+      values >> this->sceneFile;
+      this->sceneFile = resolve(filename, this->sceneFile);
+    }
+    else if ("kinematics" == key)
+    {
+      values >> this->kinematicsFile;
+      this->kinematicsFile = resolve(filename, this->kinematicsFile);
+    }
+    else if ("seed" == key)
+    {
+      values >> this->seed;
+    }
+    else if ("query" == key)
+    {
+      ScenarioQuery query;
+      std::string difficulty;
+
+      if (!(values >> query.name >> difficulty) || !ScenarioQuery::parse(difficulty, query.difficulty))
+      {
+        return false;
+      }
+
+      std::vector<rl::math::Real> angles;
+      rl::math::Real angle;
+
+      while (values >> angle)
+      {
+        angles.push_back(angle * rl::math::DEG2RAD);
+      }
+
+      //  The dof is only known once the kinematics are loaded, start and goal just have to match
+      if (angles.empty() || 0 != angles.size() % 2)
+      {
+        return false;
+      }
+
+      std::size_t dof = angles.size() / 2;
+      query.start = Eigen::Map<rl::math::Vector>(angles.data(), dof);
+      query.goal = Eigen::Map<rl::math::Vector>(angles.data() + dof, dof);
+      this->queries.push_back(query);
+    }
+    else if ("generate" == key)
+    {
+      std::string difficulty;
+      std::pair<ScenarioQuery::Difficulty, std::size_t> request;
+
+      if (!(values >> difficulty >> request.second) || !ScenarioQuery::parse(difficulty, request.first))
+      {
+        return false;
+      }
+
+      this->pending.push_back(request);
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  return !this->sceneFile.empty() && !this->kinematicsFile.empty();
+}
+
+void Scenario::save(std::ostream& out) const
+{
+  out << "name " << this->name << std::endl;
+  out << "scene " << this->sceneFile << std::endl;
+  out << "kinematics " << this->kinematicsFile << std::endl;
+  out << "seed " << this->seed << std::endl;
+
+  //  Generated angles are written exactly, so the queries read back stay collision free
+  std::streamsize precision = out.precision(std::numeric_limits<rl::math::Real>::max_digits10);
+
+  for (std::size_t i = 0; i < this->queries.size(); ++i)
+  {
+    const ScenarioQuery& query = this->queries[i];
+    out << "query " << query.name << " " << ScenarioQuery::getName(query.difficulty);
+
+    for (std::size_t j = 0; j < static_cast<std::size_t>(query.start.size()); ++j)
+    {
+      out << " " << query.start(j) * rl::math::RAD2DEG;
+    }
+
+    for (std::size_t j = 0; j < static_cast<std::size_t>(query.goal.size()); ++j)
+    {
+      out << " " << query.goal(j) * rl::math::RAD2DEG;
+    }
+
+    out << std::endl;
+  }
+
+  out.precision(precision);
+
+  for (std::size_t i = 0; i < this->pending.size(); ++i)
+  {
+    out << "generate " << ScenarioQuery::getName(this->pending[i].first) << " " << this->pending[i].second << std::endl;
+  }
+}
+
+bool Scenario::generate(TutorialPlanSystem& system)
+{
+  system.seed(this->seed);
+
+  while (!this->pending.empty())
+  {
+    std::pair<ScenarioQuery::Difficulty, std::size_t>& request = this->pending.front();
+
+    //  Number the queries per difficulty, across several generate lines
+    std::size_t index = 0;
+
+    for (std::size_t i = 0; i < this->queries.size(); ++i)
+    {
+      index += request.first == this->queries[i].difficulty ? 1 : 0;
+    }
+
+    for (std::size_t i = 0; i < request.second; ++i)
+    {
+      ScenarioQuery query;
+      query.name = std::string(ScenarioQuery::getName(request.first)) + std::to_string(index + i);
+      query.difficulty = request.first;
+
+      if (!system.generateQuery(query.difficulty, query.start, query.goal))
+      {
+        return false;
+      }
+
+      this->queries.push_back(query);
+    }
+
+    this->pending.erase(this->pending.begin());
+  }
+
+  return true;
+}
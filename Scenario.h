@@ -0,0 +1,70 @@
+#ifndef _SCENARIO_H_
+#define _SCENARIO_H_
+
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <rl/math/Vector.h>
+
+class TutorialPlanSystem;
+
+//  One start/goal pair of a scenario
+struct ScenarioQuery
+{
+  enum Difficulty
+  {
+    DIFFICULTY_EASY, //the straight line from start to goal is free
+    DIFFICULTY_MEDIUM, //the straight line from start to goal collides
+    DIFFICULTY_NARROW //start or goal lie in a narrow passage, generated ones have the goal there
+  };
+
+  static const char* getName(Difficulty difficulty);
+
+  static bool parse(const std::string& name, Difficulty& difficulty);
+
+  std::string name;
+  Difficulty difficulty;
+  rl::math::Vector start;
+  rl::math::Vector goal;
+};
+
+//  A scene, the robot and the queries planned in it, read from a text file:
+//
+//    name wall
+//    scene ../xml/rlsg/unimation-puma560-rbo_wall.xml
+//    kinematics ../xml/rlkin/unimation-puma560.xml
+//    seed 1
+//    query <name> <difficulty> <start angles [deg]> <goal angles [deg]>
+//    generate <difficulty> <count>
+//
+//  Relative scene and kinematics paths are relative to the scenario file, # starts a comment.
+class Scenario
+{
+public:
+  Scenario();
+  virtual ~Scenario();
+
+  bool load(const std::string& filename);
+
+  //  Writes the scenario in the format of load(), the generated queries listed as query lines
+  void save(std::ostream& out) const;
+
+  //  Draws the queries of the generate lines in the scene of system, reproducible with seed
+  bool generate(TutorialPlanSystem& system);
+
+  std::string name;
+
+  std::string sceneFile;
+
+  std::string kinematicsFile;
+
+  std::mt19937::result_type seed; //seed for generate()
+
+  std::vector<ScenarioQuery> queries;
+
+  std::vector< std::pair<ScenarioQuery::Difficulty, std::size_t> > pending; //queries generate() has yet to draw
+};
+
+#endif
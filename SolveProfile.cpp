@@ -0,0 +1,50 @@
+#include "SolveProfile.h"
+
+const char*
+SolveProfile::getName(const Phase& phase)
+{
+  switch (phase)
+  {
+  case PHASE_CHOOSE:
+    return "choose";
+  case PHASE_NEAREST:
+    return "nearest";
+  case PHASE_CONNECT:
+    return "connect";
+  case PHASE_CROSS_CONNECT:
+    return "cross_connect";
+  case PHASE_LOCAL_TREES:
+    return "local_trees";
+  default:
+    return "";
+  }
+}
+
+bool
+SolveProfile::isEnabled()
+{
+#ifdef TUTORIAL_PLAN_PROFILE
+  return true;
+#else
+  return false;
+#endif
+}
+
+SolveProfile::SolveProfile()
+{
+  this->reset();
+}
+
+void
+SolveProfile::reset()
+{
+  for (::std::size_t i = 0; i < PHASE_COUNT; ++i)
+  {
+    this->duration[i] = ::std::chrono::steady_clock::duration::zero();
+    this->calls[i] = 0;
+    this->queries[i] = 0;
+  }
+
+  this->connectSteps = 0;
+  this->exhaustedSkips = 0;
+}
@@ -0,0 +1,100 @@
+#ifndef _SOLVE_PROFILE_H_
+#define _SOLVE_PROFILE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <rl/plan/Model.h>
+
+/**
+*	Time and collision queries per phase of YourPlanner::solve(). Only collected if compiled
+*	with TUTORIAL_PLAN_PROFILE (cmake -DTUTORIAL_PLAN_PROFILE=ON), otherwise the hooks compile
+*	to nothing and all counts stay zero.
+*/
+struct SolveProfile
+{
+  enum Phase
+  {
+    /** Drawing the sample */
+    PHASE_CHOOSE = 0,
+    /** Nearest neighbour of the sample in the growing tree */
+    PHASE_NEAREST = 1,
+    /** Connecting the growing tree to the sample */
+    PHASE_CONNECT = 2,
+    /** Nearest neighbour in and connect of the other tree to the new vertex */
+    PHASE_CROSS_CONNECT = 3,
+    /** Seeding local trees and connecting them to new vertices */
+    PHASE_LOCAL_TREES = 4,
+    PHASE_COUNT = 5
+  };
+
+  static const char* getName(const Phase& phase);
+
+  /** Whether the hooks are compiled in */
+  static bool isEnabled();
+
+  SolveProfile();
+
+  void reset();
+
+  ::std::chrono::steady_clock::duration duration[PHASE_COUNT];
+
+  ::std::size_t calls[PHASE_COUNT];
+
+  /** Collision queries of the model during the phase */
+  ::std::size_t queries[PHASE_COUNT];
+
+  /** Interpolation steps of connect(), each one a collision query */
+  ::std::size_t connectSteps;
+
+  /** Vertices the nearest neighbour searches of the solve loop passed over because they were exhausted */
+  ::std::size_t exhaustedSkips;
+};
+
+/** Adds the time and the collision queries from its construction to its destruction to one phase */
+class SolveProfileScope
+{
+public:
+  SolveProfileScope(SolveProfile& profile, const SolveProfile::Phase& phase, const ::rl::plan::Model& model) :
+    profile(profile),
+    phase(phase),
+    model(model),
+    queries(model.getTotalQueries()),
+    start(::std::chrono::steady_clock::now())
+  {
+  }
+
+  ~SolveProfileScope()
+  {
+    this->profile.duration[this->phase] += ::std::chrono::steady_clock::now() - this->start;
+    this->profile.queries[this->phase] += this->model.getTotalQueries() - this->queries;
+    ++this->profile.calls[this->phase];
+  }
+
+private:
+  SolveProfile& profile;
+
+  SolveProfile::Phase phase;
+
+  const ::rl::plan::Model& model;
+
+  ::std::size_t queries;
+
+  ::std::chrono::steady_clock::time_point start;
+};
+
+#ifdef TUTORIAL_PLAN_PROFILE
+/** Evaluates expression as part of phase, e.g. Neighbor n = SOLVE_PROFILE(PHASE_NEAREST, this->nearest(tree, q)); */
+#define SOLVE_PROFILE(phase, expression) (SolveProfileScope(this->profile, SolveProfile::phase, *this->model), expression)
+#define SOLVE_PROFILE_COUNT(counter) (++this->profile.counter)
+/** Adds n to a counter, e.g. SOLVE_PROFILE_ADD(exhaustedSkips, this->nearestSkips); */
+#define SOLVE_PROFILE_ADD(counter, n) (this->profile.counter += (n))
+/** Adds the rest of the enclosing block to phase, for phases of more than one expression */
+#define SOLVE_PROFILE_SCOPE(phase) SolveProfileScope solveProfileScope(this->profile, SolveProfile::phase, *this->model)
+#else
+#define SOLVE_PROFILE(phase, expression) (expression)
+#define SOLVE_PROFILE_COUNT(counter)
+#define SOLVE_PROFILE_ADD(counter, n)
+#define SOLVE_PROFILE_SCOPE(phase)
+#endif
+
+#endif
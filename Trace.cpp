@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "Report.h"
+#include "Trace.h"
+
+::std::atomic<bool> Trace::active(false);
+
+::std::vector<Trace::Event> Trace::events;
+
+::std::atomic< ::std::uint64_t > Trace::next(0);
+
+::std::chrono::steady_clock::time_point Trace::origin;
+
+::std::atomic< ::std::uint32_t > Trace::threads(0);
+
+::std::mutex Trace::mutex;
+
+::std::vector< ::std::pair< ::std::uint32_t, ::std::string > > Trace::threadNames;
+
+void
+Trace::start(const ::std::size_t& capacity)
+{
+  ::std::lock_guard< ::std::mutex > lock(mutex);
+  active.store(false);
+  events.assign((::std::max)(capacity, static_cast< ::std::size_t >(1)), Event());
+  next.store(0);
+  origin = ::std::chrono::steady_clock::now();
+  active.store(true);
+}
+
+void
+Trace::stop()
+{
+  active.store(false);
+}
+
+bool
+Trace::isEnabled()
+{
+#ifdef TUTORIAL_PLAN_TRACE
+  return true;
+#else
+  return false;
+#endif
+}
+
+::std::uint32_t
+Trace::getThread()
+{
+  static thread_local ::std::uint32_t thread = threads.fetch_add(1);
+  return thread;
+}
+
+void
+Trace::setThreadName(const ::std::string& name)
+{
+  ::std::uint32_t thread = getThread();
+  ::std::lock_guard< ::std::mutex > lock(mutex);
+
+  for (::std::size_t i = 0; i < threadNames.size(); ++i)
+  {
+    if (thread == threadNames[i].first)
+    {
+      threadNames[i].second = name;
+      return;
+    }
+  }
+
+  threadNames.push_back(::std::make_pair(thread, name));
+}
+
+void
+Trace::record(const char* name, const char* category, const ::std::chrono::steady_clock::time_point& begin, const ::std::chrono::steady_clock::time_point& end)
+{
+  if (!isActive())
+  {
+    return;
+  }
+
+  // Every span gets its own slot, threads only collide after the buffer wrapped around once more while they write
+  Event& event = events[next.fetch_add(1, ::std::memory_order_relaxed) % events.size()];
+  event.name = name;
+  event.category = category;
+  event.begin = ::std::chrono::duration_cast< ::std::chrono::nanoseconds >(begin - origin).count();
+  event.duration = ::std::chrono::duration_cast< ::std::chrono::nanoseconds >(end - begin).count();
+  event.thread = getThread();
+}
+
+::std::size_t
+Trace::getDropped()
+{
+  ::std::uint64_t recorded = next.load();
+  return recorded > events.size() ? static_cast< ::std::size_t >(recorded - events.size()) : 0;
+}
+
+bool
+Trace::write(const ::std::string& filename)
+{
+  ::std::ofstream out(filename.c_str(), ::std::ios::trunc);
+
+  if (!out)
+  {
+    return false;
+  }
+
+  ::std::lock_guard< ::std::mutex > lock(mutex);
+
+  ::std::uint64_t recorded = next.load();
+  ::std::uint64_t count = (::std::min)(recorded, static_cast< ::std::uint64_t >(events.size()));
+  bool first = true;
+
+  out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+  for (::std::size_t i = 0; i < threadNames.size(); ++i)
+  {
+    out << (first ? "" : ",") << ::std::endl << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << threadNames[i].first << ", \"args\": {\"name\": ";
+    writeString(out, threadNames[i].second);
+    out << "}}";
+    first = false;
+  }
+
+  out << ::std::fixed << ::std::setprecision(3);
+
+  // Oldest span first
+  for (::std::uint64_t i = recorded - count; i < recorded; ++i)
+  {
+    const Event& event = events[i % events.size()];
+    out << (first ? "" : ",") << ::std::endl << "{\"name\": ";
+    writeString(out, event.name);
+    out << ", \"cat\": ";
+    writeString(out, event.category);
+    out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+        << ", \"ts\": " << event.begin / 1000.0 << ", \"dur\": " << event.duration / 1000.0 << "}";
+    first = false;
+  }
+
+  out << ::std::endl << "]}" << ::std::endl;
+
+  return static_cast<bool>(out);
+}
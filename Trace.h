@@ -0,0 +1,128 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+*	Records spans of a planning run and writes them in the Chrome trace event format,
+*	to be opened with chrome://tracing or ui.perfetto.dev.
+*
+*	The spans go to a ring buffer of fixed size, once it is full the oldest ones are
+*	overwritten, so a long run costs neither more memory nor more time per span.
+*	The hooks are only compiled in with TUTORIAL_PLAN_TRACE (cmake -DTUTORIAL_PLAN_TRACE=ON)
+*	and only record between start() and stop().
+*/
+class Trace
+{
+public:
+  /** Clears the buffer and starts recording into capacity spans */
+  static void start(const ::std::size_t& capacity = 1 << 18);
+
+  static void stop();
+
+  static bool isActive()
+  {
+    return active.load(::std::memory_order_relaxed);
+  }
+
+  /** Whether the hooks are compiled in */
+  static bool isEnabled();
+
+  /** Names the calling thread in the trace, e.g. the workers of a batch */
+  static void setThreadName(const ::std::string& name);
+
+  /** Adds a span, name and category have to be string literals or otherwise outlive the trace */
+  static void record(const char* name, const char* category, const ::std::chrono::steady_clock::time_point& begin, const ::std::chrono::steady_clock::time_point& end);
+
+  /** Writes the recorded spans, returns false if filename cannot be written */
+  static bool write(const ::std::string& filename);
+
+  /** Spans that were overwritten since start() */
+  static ::std::size_t getDropped();
+
+private:
+  struct Event
+  {
+    const char* name;
+
+    const char* category;
+
+    /** [ns] since start() */
+    ::std::int64_t begin;
+
+    /** [ns] */
+    ::std::int64_t duration;
+
+    ::std::uint32_t thread;
+  };
+
+  /** Small number of the calling thread, assigned on its first span */
+  static ::std::uint32_t getThread();
+
+  static ::std::atomic<bool> active;
+
+  static ::std::vector<Event> events;
+
+  /** Spans recorded since start(), the next one goes to events[next % events.size()] */
+  static ::std::atomic< ::std::uint64_t > next;
+
+  static ::std::chrono::steady_clock::time_point origin;
+
+  static ::std::atomic< ::std::uint32_t > threads;
+
+  static ::std::mutex mutex;
+
+  static ::std::vector< ::std::pair< ::std::uint32_t, ::std::string > > threadNames;
+};
+
+/** Records the span from its construction to its destruction if the trace is active */
+class TraceScope
+{
+public:
+  TraceScope(const char* name, const char* category) :
+    name(name),
+    category(category),
+    active(Trace::isActive())
+  {
+    if (this->active)
+    {
+      this->begin = ::std::chrono::steady_clock::now();
+    }
+  }
+
+  ~TraceScope()
+  {
+    if (this->active)
+    {
+      Trace::record(this->name, this->category, this->begin, ::std::chrono::steady_clock::now());
+    }
+  }
+
+private:
+  const char* name;
+
+  const char* category;
+
+  bool active;
+
+  ::std::chrono::steady_clock::time_point begin;
+};
+
+#ifdef TUTORIAL_PLAN_TRACE
+#define TRACE_CONCATENATE_(a, b) a##b
+#define TRACE_CONCATENATE(a, b) TRACE_CONCATENATE_(a, b)
+/** Traces the rest of the enclosing block */
+#define TRACE_SCOPE(name, category) TraceScope TRACE_CONCATENATE(traceScope, __LINE__)(name, category)
+#define TRACE_THREAD_NAME(name) Trace::setThreadName(name)
+#else
+#define TRACE_SCOPE(name, category)
+#define TRACE_THREAD_NAME(name)
+#endif
+
+#endif
@@ -1,22 +1,90 @@
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
 #include <fstream>
-#include <QDateTime>
+#include <iomanip>
+#include <sstream>
+#include "AllocationCounter.h"
 #include "TutorialPlanSystem.h"
+#include "Trace.h"
 #include "rl/math/Unit.h"
 #include "rl/math/Rotation.h"
 #include "rl/plan/UniformSampler.h"
 #include <iostream>
 
+namespace
+{
+  //  Current local date and time as yyyy-MM-dd,HH:mm:ss.zzz
+  std::string timestamp()
+  {
+    std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+    std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d,%H:%M:%S", std::localtime(&seconds));
+
+    std::ostringstream out;
+    out << buffer << "." << std::setw(3) << std::setfill('0') << milliseconds;
+    return out.str();
+  }
+
+  //  Points a planner at one stretch of a path, its query and time limit are restored and
+  //  its trees are dropped on every way out, so nothing of the repair leaks into the next solve
+  class RepairScope
+  {
+  public:
+    RepairScope(rl::plan::Planner& planner, rl::math::Vector& start, rl::math::Vector& goal, std::chrono::steady_clock::duration duration) :
+      planner(planner),
+      start(planner.start),
+      goal(planner.goal),
+      duration(planner.duration)
+    {
+      this->planner.start = &start;
+      this->planner.goal = &goal;
+      this->planner.duration = duration;
+      this->planner.reset();
+    }
+
+    ~RepairScope()
+    {
+      this->planner.start = this->start;
+      this->planner.goal = this->goal;
+      this->planner.duration = this->duration;
+      this->planner.reset();
+    }
 
-TutorialPlanSystem::TutorialPlanSystem()
+  private:
+    rl::plan::Planner& planner;
+    rl::math::Vector* start;
+    rl::math::Vector* goal;
+    std::chrono::steady_clock::duration duration;
+  };
+}
+
+
+TutorialPlanSystem::TutorialPlanSystem(const std::string& sceneFile, const std::string& kinematicsFile) :
+  sceneFile(sceneFile),
+  kinematicsFile(kinematicsFile),
+  sampleCacheFile(),
+  useRoadmap(false),
+  roadmapFile("roadmap.bin"),
+  useReference(false),
+  useExperience(false),
+  libraryFile("paths.bin"),
+  experienceRadius(30 * rl::math::DEG2RAD),
+  repairDuration(std::chrono::seconds(10)),
+  solveBegin(),
+  solveEnd()
 {
   //  Loading the scene from an predefined xml file which contains the convex model of the robot as well as the sourroundings
   //  Here's the collision scene where the puma 560 is loaded.
   rl::sg::bullet::Scene* scene = new rl::sg::bullet::Scene();
-  scene->load("../xml/rlsg/unimation-puma560-rbo_wall.xml");
+  scene->load(sceneFile);
   rl::sg::bullet::Model* sceneModel = static_cast< rl::sg::bullet::Model* > (scene->getModel(0));
 
   //  Loading the kinematics of the puma 560 from a predefined xml file
-  rl::kin::Kinematics* kinematics = rl::kin::Kinematics::create("../xml/rlkin/unimation-puma560.xml");
+  rl::kin::Kinematics* kinematics = rl::kin::Kinematics::create(kinematicsFile);
   kinematics->world() = ::rl::math::AngleAxis(90 * rl::math::DEG2RAD, ::rl::math::Vector3::UnitZ());
   kinematics->world().translation().x() = 0;
   kinematics->world().translation().y() = 0;
@@ -49,6 +117,12 @@ TutorialPlanSystem::TutorialPlanSystem()
   //  Set the model of the sampler to the system model
   this->sampler.model = &this->model;
 
+  //  Cached data of previous runs is only valid for the same scene, robot and geometry
+  std::vector<std::string> files;
+  files.push_back(sceneFile);
+  files.push_back(kinematicsFile);
+  this->fingerprint = fingerprintFiles(files);
+
   //  --- Parametrize the planner ---
   //  Delta defines the configuration step width of a connect attempt.
   //  Here delta is set to 1° => 1° steps are checked during a connect.
@@ -71,6 +145,24 @@ TutorialPlanSystem::TutorialPlanSystem()
   this->planner.sampler = &this->sampler;
   this->planner.model = &this->model;
 
+  //  The roadmap planner uses the same resolution, model and time limit.
+  this->roadmap.delta = this->planner.delta;
+  this->roadmap.epsilon = this->planner.epsilon;
+  this->roadmap.duration = this->planner.duration;
+  this->roadmap.goal = &this->goal;
+  this->roadmap.start = &this->start;
+  this->roadmap.sampler = &this->sampler;
+  this->roadmap.model = &this->model;
+
+  //  And so does the reference planner.
+  this->reference.delta = this->planner.delta;
+  this->reference.epsilon = this->planner.epsilon;
+  this->reference.duration = this->planner.duration;
+  this->reference.goal = &this->goal;
+  this->reference.start = &this->start;
+  this->reference.sampler = &this->sampler;
+  this->reference.model = &this->model;
+
   //  Set the parameters of the optimizer - you do not need to change these
   this->optimizer.length = 15 * rl::math::DEG2RAD;
   this->optimizer.ratio = 0.05;
@@ -89,6 +181,49 @@ TutorialPlanSystem::~TutorialPlanSystem()
   delete this->model.scene;
 }
 
+void TutorialPlanSystem::seed(std::mt19937::result_type value)
+{
+  this->sampler.seed(value);
+}
+
+void TutorialPlanSystem::setUseRoadmap(bool useRoadmap)
+{
+  //  A roadmap of a previous run can answer queries right away, unless one was built or loaded already
+  if (useRoadmap && !this->useRoadmap && 0 == this->roadmap.getNumVertices())
+  {
+    this->roadmap.load(this->roadmapFile, this->fingerprint);
+  }
+
+  this->useRoadmap = useRoadmap;
+}
+
+void TutorialPlanSystem::setUseExperience(bool useExperience)
+{
+  //  So can the paths of previous runs
+  if (useExperience && !this->useExperience && 0 == this->library.size())
+  {
+    this->library.load(this->libraryFile, this->fingerprint);
+  }
+
+  this->useExperience = useExperience;
+}
+
+void TutorialPlanSystem::setSampleCacheFile(const std::string& filename)
+{
+  this->sampleCacheFile = filename;
+
+  if (filename.empty())
+  {
+    this->sampleCache.clear();
+    this->sampler.cache = NULL;
+    return;
+  }
+
+  //  A missing or outdated file starts an empty cache that plan() writes
+  this->sampleCache.load(filename, this->fingerprint, this->model.getDof());
+  this->sampler.cache = &this->sampleCache;
+}
+
 void TutorialPlanSystem::getRandomConfiguration(rl::math::Vector & config)
 {
   //  By calling generate the sampler returns a random configuration
@@ -103,6 +238,50 @@ void TutorialPlanSystem::getRandomFreeConfiguration(rl::math::Vector & config)
   config = sampler.generateCollisionFree();
 }
 
+bool TutorialPlanSystem::generateQuery(ScenarioQuery::Difficulty difficulty, rl::math::Vector & start, rl::math::Vector & goal)
+{
+  const std::size_t attempts = 1000;
+
+  //  Generated queries neither come from nor end up in the sample cache
+  SampleCache* cache = this->sampler.cache;
+  this->sampler.cache = NULL;
+  this->sampler.setSigma(this->planner.sigma);
+  //  Bounded whatever the planner uses, a narrow goal is only accepted if the bridge sampler did not give up,
+  //  and the queries of a scenario stay the same for the same seed
+  this->sampler.maxAttempts = 100;
+
+  bool found = false;
+
+  for (std::size_t i = 0; i < attempts && !found; ++i)
+  {
+    start = this->sampler.generateCollisionFree();
+
+    if (ScenarioQuery::DIFFICULTY_NARROW == difficulty)
+    {
+      //  A bridge sample lies between two obstacles, unless the sampler gave up and fell back to uniform sampling
+      std::size_t fallbacks = this->sampler.bridgeStats.fallbacks;
+      goal = this->sampler.generateBridge();
+
+      if (this->sampler.bridgeStats.fallbacks != fallbacks)
+      {
+        continue;
+      }
+    }
+    else
+    {
+      goal = this->sampler.generateCollisionFree();
+    }
+
+    bool direct = !this->verifier.isColliding(start, goal, this->model.distance(start, goal));
+    found = (ScenarioQuery::DIFFICULTY_EASY == difficulty) == direct;
+  }
+
+  this->sampler.cache = cache;
+  this->model.reset();
+
+  return found;
+}
+
 void TutorialPlanSystem::writeToFile(rl::plan::VectorList & path)
 {
   std::ofstream traj;
@@ -136,58 +315,215 @@ void TutorialPlanSystem::writeToFile(rl::plan::VectorList & path)
   traj.close();
 }
 
-bool TutorialPlanSystem::plan(rl::plan::VectorList & path)
+bool TutorialPlanSystem::solveQuery(rl::plan::VectorList & path, PlanResult & result)
 {
+  TRACE_SCOPE("solveQuery", "system");
+  rl::plan::Planner& planner = this->getPlanner();
+
+  result.valid = false;
+  result.solved = false;
+  result.reused = false;
+  result.duration = 0;
+  result.vertices = 0;
+  result.totalQueries = 0;
+  result.freeQueries = 0;
+  result.length = 0;
+  result.profile.reset();
+  result.treeBytes.clear();
+  result.vertexBytes = 0;
+  result.peakBytes = 0;
+  result.allocations = 0;
 
   //Verifies that the model, the start, and the goal position are all correct
-  if (!this->planner.verify())
+  if (!planner.verify())
   {
-    std::cout << "start or goal invalid" << std::endl;
     return false;
   }
 
+  result.valid = true;
+
+  //The peak is process wide, it only belongs to this query if no other thread plans meanwhile
+  AllocationCounter::Snapshot before = AllocationCounter::resetPeak();
+
+  if (this->solveBegin)
+  {
+    this->solveBegin();
+  }
+
   //Call the planner to solve the current problem.
-  std::cout << "solve() ... " << std::endl;;
   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
-  bool solved = this->planner.solve();
+  bool solved = false;
+
+  //Try to repair the stored path of a similar query first
+  if (this->useExperience)
+  {
+    solved = result.reused = this->planFromExperience(path);
+  }
+
+  if (!solved)
+  {
+    //A repair that failed partway must not hand its trees to the real query
+    if (this->useExperience)
+    {
+      planner.reset();
+    }
+
+    solved = planner.solve();
+
+    if (solved)
+    {
+      path = planner.getPath();
+    }
+  }
+
   std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
 
-  double plannerDuration = std::chrono::duration_cast< std::chrono::duration<double>>(stop - start).count() * 1000;
-  //this->showMessage("Planner " + std::string(solved ? "succeeded" : "failed") + " in " + QString::number(plannerDuration).toStdString() + " ms.");
-  std::cout << "solve() " << (solved ? "true" : "false") << " " << QString::number(plannerDuration).toStdString() << " ms" << std::endl;
+  if (this->solveEnd)
+  {
+    this->solveEnd();
+  }
+
+  AllocationCounter::Snapshot after = AllocationCounter::get();
+  result.peakBytes = after.peak - before.live;
+  result.allocations = after.allocations - before.allocations;
+
+  result.solved = solved;
+  result.duration = std::chrono::duration_cast< std::chrono::duration<double>>(stop - start).count() * 1000;
+  result.vertices = planner.getNumVertices();
+  result.totalQueries = this->model.getTotalQueries();
+  result.freeQueries = this->model.getFreeQueries();
+
+  if (&planner == &this->planner)
+  {
+    result.profile = this->planner.profile;
+    result.treeBytes = this->planner.getTreeMemory();
+    result.vertexBytes = result.vertices > 0 ? static_cast<double>(this->planner.getMemory()) / result.vertices : 0;
+  }
+
+  //Optimize the trajectory (if the planner could solve in time)
+  if(solved)
+  {
+    //optimize the trajectory.
+    //Comment this line if you only want to test your planning algorithm
+    {
+      TRACE_SCOPE("optimize", "optimizer");
+      this->optimizer.process(path);
+    }
+
+    rl::plan::VectorList::iterator i = path.begin();
+
+    for (rl::plan::VectorList::iterator j = ++path.begin(); j != path.end(); ++i, ++j)
+    {
+      result.length += this->model.distance(*i, *j);
+    }
+
+    //Remember the path for similar queries
+    if (this->useExperience)
+    {
+      this->library.add(path);
+    }
+  }
+
+  return solved;
+}
+
+bool TutorialPlanSystem::plan(rl::plan::VectorList & path)
+{
+  TRACE_SCOPE("plan", "system");
+  rl::plan::Planner& planner = this->getPlanner();
+
+  //Call the planner to solve the current problem and optimize the result.
+  std::cout << "solve() ... " << std::endl;;
+  PlanResult result;
+  bool solved = this->solveQuery(path, result);
+
+  if (!result.valid)
+  {
+    std::cout << "start or goal invalid" << std::endl;
+    return false;
+  }
+
+  if (this->useExperience)
+  {
+    std::cout << "experience " << (result.reused ? "reused" : "not usable") << std::endl;
+  }
+
+  double plannerDuration = result.duration;
+  std::cout << "solve() " << (solved ? "true" : "false") << " " << plannerDuration << " ms" << std::endl;
 
 
   //write statistics to file benchmark.csv
   //format: date, time, solved, Planner name, # vertices, # Collision queries, # non-colliding queries, running time
   std::ofstream benchmark;
   benchmark.open("benchmark.csv", std::ios::app);
-  benchmark << QDateTime::currentDateTime().toString("yyyy-MM-dd,HH:mm:ss.zzz").toStdString();
+  benchmark << timestamp();
   benchmark << ",";
   benchmark << (solved ? "true" : "false");
   benchmark << ",";
-  benchmark << this->planner.getName();
+  benchmark << planner.getName();
   benchmark << ",";
-  benchmark << this->planner.getNumVertices();
+  benchmark << result.vertices;
   benchmark << ",";
-  benchmark << this->model.getTotalQueries();
+  benchmark << result.totalQueries;
   benchmark << ",";
-  benchmark << this->model.getFreeQueries();
+  benchmark << result.freeQueries;
   benchmark << ",";
-  benchmark << QString::number(plannerDuration).toStdString();
+  benchmark << plannerDuration;
   benchmark << std::endl;
 
+  //Cost of the rejection samplers, attempts per accepted sample and uniform fallbacks
+  std::cout << "gaussian sampler: " << this->sampler.gaussianStats.accepted << " accepted, "
+            << this->sampler.gaussianStats.attemptsPerAccepted() << " attempts/sample, "
+            << this->sampler.gaussianStats.fallbacks << " fallbacks" << std::endl;
+  std::cout << "bridge sampler: " << this->sampler.bridgeStats.accepted << " accepted, "
+            << this->sampler.bridgeStats.attemptsPerAccepted() << " attempts/sample, "
+            << this->sampler.bridgeStats.fallbacks << " fallbacks" << std::endl;
 
-  //Optimize the trajectory (if the planner could solve in time)
-  if(solved)
+  //Connect attempts between start and goal tree and how many of them joined the trees
+  if (&planner == &this->planner)
   {
-    //Found a solution so return the found path
-    path = this->planner.getPath();
+    std::cout << "tree connects: " << this->planner.cross_connect_successes << "/" << this->planner.cross_connect_attempts << " successful" << std::endl;
+    std::cout << "tree memory: " << result.treeBytes[0] << " bytes start, " << result.treeBytes[1] << " bytes goal, "
+              << this->planner.getMemory() << " bytes total, " << result.vertexBytes << " bytes/vertex" << std::endl;
+  }
 
-    std::cout << "optimize() ... " << std::endl;;
+  //Only counted if the allocation functions are replaced in this executable
+  if (AllocationCounter::isInstalled())
+  {
+    std::cout << "heap: " << result.peakBytes << " bytes peak growth, " << result.allocations << " allocations" << std::endl;
+  }
 
-    //optimize the trajectory.
-    //Comment this line if you only want to test your planning algorithm
-    this->optimizer.process(path);
+  //Where solve() spent its time, if compiled with TUTORIAL_PLAN_PROFILE
+  if (SolveProfile::isEnabled() && &planner == &this->planner)
+  {
+    for (std::size_t i = 0; i < SolveProfile::PHASE_COUNT; ++i)
+    {
+      SolveProfile::Phase phase = static_cast<SolveProfile::Phase>(i);
+      std::cout << SolveProfile::getName(phase) << ": "
+                << std::chrono::duration_cast< std::chrono::duration<double, std::milli> >(result.profile.duration[i]).count() << " ms, "
+                << result.profile.calls[i] << " calls, " << result.profile.queries[i] << " collision queries" << std::endl;
+    }
+
+    std::cout << "connect steps: " << result.profile.connectSteps << ", exhausted skips: " << result.profile.exhaustedSkips << std::endl;
+  }
+
+  //Keep the samples found by rejection sampling, the roadmap and the paths for the next run
+  if (!this->sampleCacheFile.empty())
+  {
+    this->sampleCache.save(this->sampleCacheFile);
+  }
+
+  if (this->useRoadmap)
+  {
+    this->roadmap.save(this->roadmapFile, this->fingerprint);
+  }
+
+  if(solved)
+  {
+    if (this->useExperience)
+    {
+      this->library.save(this->libraryFile, this->fingerprint);
+    }
 
     //Write trajectory to text file
     writeToFile(path);
@@ -196,10 +532,100 @@ bool TutorialPlanSystem::plan(rl::plan::VectorList & path)
   return solved;
 }
 
+bool TutorialPlanSystem::planFromExperience(rl::plan::VectorList & path)
+{
+  TRACE_SCOPE("experience", "system");
+
+  rl::plan::VectorList candidate;
+  rl::math::Real distance;
+
+  if (!this->library.nearest(this->start, this->goal, candidate, distance) || distance > this->experienceRadius)
+  {
+    return false;
+  }
+
+  //Move the ends of the stored path to the current query, the changed segments are verified with the rest
+  candidate.front() = this->start;
+  candidate.back() = this->goal;
+
+  if (!this->repairPath(candidate))
+  {
+    return false;
+  }
+
+  path = candidate;
+  return true;
+}
+
+bool TutorialPlanSystem::repairPath(rl::plan::VectorList & path)
+{
+  std::vector<rl::math::Vector> q(path.begin(), path.end());
+  std::vector<bool> free(q.size());
+
+  for (size_t i = 0; i < q.size(); ++i)
+  {
+    this->model.setPosition(q[i]);
+    this->model.updateFrames();
+    free[i] = !this->model.isColliding();
+  }
+
+  if (!free.front() || !free.back())
+  {
+    return false;
+  }
+
+  rl::plan::VectorList repaired;
+  repaired.push_back(q.front());
+
+  size_t i = 0;
+
+  while (i + 1 < q.size())
+  {
+    //Keep every segment that is still free
+    if (free[i + 1] && !this->verifier.isColliding(q[i], q[i + 1], this->model.distance(q[i], q[i + 1])))
+    {
+      repaired.push_back(q[i + 1]);
+      ++i;
+      continue;
+    }
+
+    //Replan from the last good configuration to the next free one, the goal is free so this terminates
+    size_t j = i + 1;
+
+    while (!free[j])
+    {
+      ++j;
+    }
+
+    //The stretch is planned with the selected planner
+    rl::plan::Planner& planner = this->getPlanner();
+    rl::plan::VectorList segment;
+
+    {
+      RepairScope scope(planner, q[i], q[j], this->repairDuration);
+
+      if (!planner.solve())
+      {
+        return false;
+      }
+
+      segment = planner.getPath();
+    }
+
+    repaired.insert(repaired.end(), ++segment.begin(), segment.end());
+    i = j;
+  }
+
+  path = repaired;
+  return true;
+}
+
 void TutorialPlanSystem::reset()
 {
-  //Reset the planner and the model
+  //Reset the planner and the model, the roadmap keeps its milestones
   this->planner.reset();
+  this->roadmap.reset();
+  this->reference.reset();
   this->model.reset();
 }
 
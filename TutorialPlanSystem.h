@@ -11,14 +11,38 @@
 #include <rl/sg/bullet/Model.h>
 #include <rl/sg/so/Scene.h>
 #include <rl/sg/bullet/Scene.h>
+#include <functional>
 
+#include "PathLibrary.h"
+#include "RrtConConBase.h"
+#include "SampleCache.h"
+#include "Scenario.h"
 #include "YourPlanner.h"
+#include "YourRoadmap.h"
 #include "YourSampler.h"
 
+//  Outcome and cost of one planning query
+struct PlanResult
+{
+  bool valid; //start and goal are collision free and within the joint limits
+  bool solved;
+  bool reused; //solved by repairing a stored path
+  double duration; //[ms] spent in the planner, without optimization
+  std::size_t vertices;
+  std::size_t totalQueries; //collision queries
+  std::size_t freeQueries; //collision queries without collision
+  rl::math::Real length; //length of the optimized path
+  SolveProfile profile; //phases of YourPlanner::solve(), empty for the other planners or without TUTORIAL_PLAN_PROFILE
+  std::vector<std::size_t> treeBytes; //estimated heap bytes per tree of YourPlanner, see YourPlanner::getTreeMemory(), empty for the other planners
+  double vertexBytes; //estimated heap bytes of the trees per vertex, edges included
+  std::size_t peakBytes; //highest growth of the process heap over the section of duration, 0 without AllocationHooks.cpp
+  std::size_t allocations; //allocator calls over the section of duration, 0 without AllocationHooks.cpp
+};
+
 class TutorialPlanSystem
 {
 public:
-  TutorialPlanSystem();
+  TutorialPlanSystem(const std::string& sceneFile = "../xml/rlsg/unimation-puma560-rbo_wall.xml", const std::string& kinematicsFile = "../xml/rlkin/unimation-puma560.xml");
   virtual ~TutorialPlanSystem();
 
   rl::math::Vector& getGoalConfiguration() {return goal;}
@@ -33,30 +57,106 @@ public:
   void getRandomConfiguration(rl::math::Vector & config);
   void getRandomFreeConfiguration(rl::math::Vector & config);
 
+  //  Draws a collision free start and goal of the given difficulty, false if none is found within a number of attempts
+  bool generateQuery(ScenarioQuery::Difficulty difficulty, rl::math::Vector & start, rl::math::Vector & goal);
+
+  const std::string& getSceneFile() const {return sceneFile;}
+  const std::string& getKinematicsFile() const {return kinematicsFile;}
+
   void writeToFile(rl::plan::VectorList & path);
 
-  void setViewer(rl::plan::Viewer* viewer) {this->planner.viewer = viewer;this->optimizer.viewer=viewer;}
+  void setViewer(rl::plan::Viewer* viewer) {this->planner.viewer = viewer;this->roadmap.viewer = viewer;this->reference.viewer = viewer;this->optimizer.viewer=viewer;}
+
+  //  Answer queries with the persistent roadmap instead of building new trees every time,
+  //  the roadmap file of a previous run is loaded the first time this is enabled
+  void setUseRoadmap(bool useRoadmap);
+
+  //  Store and restore the roadmap, only files written for the same scene and robot are loaded
+  bool saveRoadmap(const std::string& filename) {return this->roadmap.save(filename, this->fingerprint);}
+  bool loadRoadmap(const std::string& filename) {return this->roadmap.load(filename, this->fingerprint);}
+
+  //  Reuse and repair stored paths of similar queries before planning from scratch,
+  //  the library file of a previous run is loaded the first time this is enabled
+  void setUseExperience(bool useExperience);
+
+  //  Plan with the unmodified RrtConConBase, e.g. to compare against it
+  void setUseReference(bool useReference) {this->useReference = useReference;}
+
+  rl::plan::Planner& getPlanner()
+  {
+    if (this->useRoadmap)
+    {
+      return this->roadmap;
+    }
+
+    return this->useReference ? static_cast<rl::plan::Planner&>(this->reference) : this->planner;
+  }
+
+  YourPlanner& getYourPlanner() {return this->planner;}
+
+  //  Seeds the sampler, which also draws the random decisions of the planner, for reproducible runs
+  void seed(std::mt19937::result_type value);
+
+  //  Draw part of the gaussian and bridge samples from the samples of previous runs stored in filename,
+  //  and write the samples found by plan() back to it. Off by default, an empty filename turns it off again.
+  void setSampleCacheFile(const std::string& filename);
+
+  //  Called on the planning thread right before and right after the planner in solveQuery(), e.g. to read
+  //  hardware counters over the same section as PlanResult::duration, empty functions for none
+  void setSolveHooks(const std::function<void()>& begin, const std::function<void()>& end) {this->solveBegin = begin;this->solveEnd = end;}
 
   bool plan(rl::plan::VectorList &);
 
+  //  Plans and optimizes without writing any output, safe to run for different systems in parallel
+  bool solveQuery(rl::plan::VectorList & path, PlanResult & result);
+
   void reset();
 
   rl::plan::DistanceModel& getModel() {return model;}
 
 private:
 
+  bool planFromExperience(rl::plan::VectorList & path);
+
+  //  Verifies every segment of path and replans the invalid parts with the selected planner
+  bool repairPath(rl::plan::VectorList & path);
+
   rl::math::Vector goal; //goal configuration
   rl::math::Vector start; //start configuration
   rl::math::Vector q; //current configuration
 
+  std::string sceneFile; //Collision scene with the robot and its surroundings
+  std::string kinematicsFile; //Kinematics of the robot
+
   rl::plan::DistanceModel model; //model for computation
 
   YourSampler sampler; //Sampler for random configurations
 
+  SampleCache sampleCache; //Gaussian and bridge samples persisted across runs
+  std::string sampleCacheFile; //File the sample cache is loaded from and saved to, empty for no cache
+
   rl::plan::AdvancedOptimizer optimizer; //Trajectory length optimizer
   rl::plan::RecursiveVerifier verifier; //The verifier for the optimizer
 
   YourPlanner planner;  //The implementation of your planner
+
+  YourRoadmap roadmap;  //Multi-query planner, keeps its roadmap across plan() calls
+  bool useRoadmap;  //Use roadmap instead of planner
+  std::string roadmapFile; //File the roadmap is loaded from and saved to
+
+  RrtConConBase reference;  //Planner YourPlanner started from
+  bool useReference;  //Use reference instead of planner
+
+  PathLibrary library; //Solved paths indexed by start and goal
+  bool useExperience; //Try the library before planning
+  std::string libraryFile; //File the library is loaded from and saved to
+  rl::math::Real experienceRadius; //Stored paths of queries further away than this are not reused
+  std::chrono::steady_clock::duration repairDuration; //Time limit for replanning one invalid part of a stored path
+
+  std::function<void()> solveBegin; //Called right before the planner in solveQuery()
+  std::function<void()> solveEnd; //Called right after it
+
+  std::uint64_t fingerprint; //Hash of the scene and kinematics files, ties cached data to them
 };
 
 #endif
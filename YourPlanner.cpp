@@ -1,21 +1,48 @@
 #include "YourPlanner.h"
+#include "Trace.h"
 #include <rl/plan/Sampler.h>
 #include <rl/plan/SimpleModel.h>
 #include <rl/plan/Verifier.h>
 #include <rl/plan/Viewer.h>
 #include <boost/make_shared.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <map>
 #include <Eigen/Dense>
 
+namespace
+{
+  /** Bytes glibc malloc takes for a block: size plus a word of header, rounded up to two words, at least four,
+      other allocators round differently so the memory of the trees is only an estimate there */
+  ::std::size_t
+  chunk(const ::std::size_t& size)
+  {
+    const ::std::size_t word = sizeof(::std::size_t);
+    return ::std::max(4 * word, (size + word + 2 * word - 1) / (2 * word) * (2 * word));
+  }
+
+  /** Bytes of a std::list node holding size bytes, next and previous pointer included, as laid out by libstdc++ */
+  ::std::size_t
+  node(const ::std::size_t& size)
+  {
+    return chunk(2 * sizeof(void*) + size);
+  }
+}
+
 YourPlanner::YourPlanner() :
   Planner(),
   delta(1.0f),
   epsilon(1.0e-3f),
   sampler(NULL),
+  best_cost((::std::numeric_limits< ::rl::math::Real >::infinity)()),
+  tree(2),
   begin(2),
   end(2),
-  tree(2)
+  starGoal(NULL),
+  nearestSkips(0)
 {
+  this->resetClosest();
   use_goal_bias = false;
   goal_bias = 0.1;
   use_neighbor_exhaustion = false;
@@ -25,6 +52,26 @@ YourPlanner::YourPlanner() :
   use_bridge_sampling = false;
   use_gaussian_along_c_path = true;
   sigma = 2*this->delta;
+  tube_sigma = 0.05;
+  tube_widen_factor = 1.5;
+  tube_stall_limit = 200;
+  use_workspace_sampling = false;
+  workspace_sigma = 0.1;
+  sampling_budget = 0;
+  use_anytime = false;
+  anytime_duration = ::std::chrono::seconds(5);
+  anytime_step_factor = 10;
+  use_dynamic_domain = false;
+  domain_radius_factor = 30;
+  domain_alpha = 0.05;
+  domain_min_radius_factor = 2;
+  domainRadius = domain_radius_factor * this->delta;
+  domainMinRadius = domain_min_radius_factor * this->delta;
+  use_informed_sampling = true;
+  use_gap_tracking = false;
+  gap_threshold = (::std::numeric_limits< ::rl::math::Real >::infinity)();
+  gap_refresh_interval = 50;
+  local_tree_attempts = 100;
   name = "BridgeSampling2delta";
   //Q = Eigen::MatrixXd(this->model->getDof(),this->model->getDof());
 }
@@ -58,9 +105,57 @@ YourPlanner::addVertex(Tree& tree, const ::rl::plan::VectorPtr& q)
     this->viewer->drawConfigurationVertex(*tree[v].q);
   }
 
+  if (this->use_gap_tracking && (&tree == &this->tree[0] || &tree == &this->tree[1]))
+  {
+    this->updateClosest(tree, v);
+  }
+
   return v;
 }
 
+void
+YourPlanner::updateClosest(const Tree& tree, const Vertex& v)
+{
+  ::std::size_t t = &tree == &this->tree[0] ? 0 : 1;
+  const Tree& other = this->tree[1 - t];
+
+  if (0 == ::boost::num_vertices(other))
+  {
+    return;
+  }
+
+  Neighbor n;
+
+  // Comparing with the tracked pair only keeps insertions O(1), a full search now and then finds pairs elsewhere
+  if (NULL == this->closest.vertex[1 - t] || ++this->closest.insertions >= this->gap_refresh_interval)
+  {
+    n = this->nearest(other, *tree[v].q);
+    this->closest.insertions = 0;
+  }
+  else
+  {
+    n = Neighbor(this->closest.vertex[1 - t], this->model->distance(*tree[v].q, *other[this->closest.vertex[1 - t]].q));
+  }
+
+  if (NULL != n.first && n.second < this->closest.distance)
+  {
+    this->closest.vertex[t] = v;
+    this->closest.vertex[1 - t] = n.first;
+    this->closest.distance = n.second;
+    this->closest.tried = false;
+  }
+}
+
+void
+YourPlanner::resetClosest()
+{
+  this->closest.vertex[0] = NULL;
+  this->closest.vertex[1] = NULL;
+  this->closest.distance = (::std::numeric_limits< ::rl::math::Real >::infinity)();
+  this->closest.tried = true;
+  this->closest.insertions = 0;
+}
+
 bool
 YourPlanner::areEqual(const ::rl::math::Vector& lhs, const ::rl::math::Vector& rhs) const
 {
@@ -77,7 +172,8 @@ YourPlanner::areEqual(const ::rl::math::Vector& lhs, const ::rl::math::Vector& r
 void // TODO: OPTIMIZE
 YourPlanner::choose(::rl::math::Vector& chosen, const ::rl::math::Vector& goal)
 {
-  float goal_p = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+  TRACE_SCOPE("choose", "planner");
+  float goal_p = this->sampler->rand();
   if (goal_p < this->goal_bias && this->use_goal_bias)
   {
     chosen = goal;
@@ -91,9 +187,13 @@ YourPlanner::choose(::rl::math::Vector& chosen, const ::rl::math::Vector& goal)
   {
     chosen = this->sampler->generateBridge();
   }
+  else if(this->use_workspace_sampling)
+  {
+    chosen = this->sampler->generateWorkspace();
+  }
   else if(this->use_gaussian_along_c_path)
   {
-    chosen = this->sampler->generateGaussianAlongCPath(this->Q, this->lengthStartGoal);
+    chosen = this->sampler->generateGaussianAlongCPath(this->Q, *this->start, this->lengthStartGoal);
   }
   else
   {
@@ -107,6 +207,9 @@ YourPlanner::choose(::rl::math::Vector& chosen, const ::rl::math::Vector& goal)
 YourPlanner::Vertex
 YourPlanner::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen)
 {
+  // One collision query per step along the line to chosen
+  TRACE_SCOPE("connect", "collision");
+
   //Do first extend step
 
   ::rl::math::Real distance = nearest.second;
@@ -127,6 +230,7 @@ YourPlanner::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vect
 
   // move "last" along the line q<->chosen by distance "step / distance"
   this->model->interpolate(*tree[nearest.first].q, chosen, step / distance, *lastQ);
+  SOLVE_PROFILE_COUNT(connectSteps);
 
   this->model->setPosition(*lastQ);
   this->model->updateFrames();
@@ -141,9 +245,18 @@ YourPlanner::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vect
       this->most_fails = tree[nearest.first].fails;
       //std::cout << "Most fails: " << this->most_fails << std::endl;
     }
+    if (this->use_dynamic_domain){
+      ::rl::math::Real& radius = tree[nearest.first].radius;
+      radius = ::std::isinf(radius) ? this->domainRadius : radius * (1 - this->domain_alpha);
+      // A domain that still contains the failed sample would not reject the next one in its direction
+      radius = (::std::max)((::std::min)(radius, nearest.second * (1 - this->domain_alpha)), this->domainMinRadius);
+    }
     return NULL;
   }else{
     tree[nearest.first].successes += 1;
+    if (this->use_dynamic_domain && !::std::isinf(tree[nearest.first].radius)){
+      tree[nearest.first].radius *= 1 + this->domain_alpha;
+    }
   }
 
   //::rl::math::Vector nextQ(this->model->getDof());
@@ -171,6 +284,7 @@ YourPlanner::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vect
 
     // move "next" along the line last<->chosen by distance "step / distance"
     this->model->interpolate(*lastQ, chosen, step / distance, *nextQ);
+    SOLVE_PROFILE_COUNT(connectSteps);
 
     this->model->setPosition(*nextQ);
     this->model->updateFrames();
@@ -206,50 +320,79 @@ YourPlanner::generateOrthonormalBasis(const Eigen::VectorXd& v)
     std::cout << "DOF does not match vector size" << std::endl;
   }
 
-  // Initialize a matrix to store vectors that will form the basis. The matrix has 'dim' rows and 'dim' columns.
-  Eigen::MatrixXd mat(dim, dim);
-  mat.col(0) = v.normalized();
-
-  // Generate additional vectors to fill the basis.
-  // Start from 1 because the first vector is already set.
-  for (int i = 1; i < dim; ++i) {
+  Eigen::MatrixXd Q;
 
-      Eigen::VectorXd vec = Eigen::VectorXd::Zero(dim); // Initialize a vector of zeros.
-
-      vec(i) = 1; // Set one element to 1 to create a simple basis vector. This is a naive way to fill the space.
-      
-      // The generated vector is added as a column to the matrix. 
-      // This process is not guaranteed to produce
-      // orthogonal vectors yet; QR decomposition will handle orthogonality and normalization later.
-      mat.col(i) = vec;
+  // Start and goal coincide, any basis will do
+  if (v.norm() <= this->epsilon)
+  {
+    Q = Eigen::MatrixXd::Identity(dim, dim);
+    return Q;
   }
 
-  // Perform QR decomposition on the matrix with the initial vectors.
-  // QR decomposition is a method to decompose a matrix into an orthogonal matrix (Q) and an upper triangular matrix (R).
-  Eigen::HouseholderQR<Eigen::MatrixXd> qr = mat.householderQr();
+  // Initialize a matrix to store vectors that will form the basis. The first column is
+  // the normalized input vector, the others are the unit vectors e_1 ... e_dim-1.
+  // This process is not guaranteed to produce orthogonal vectors yet;
+  // QR decomposition will handle orthogonality and normalization later.
+  if (6 == dim)
+  {
+    // Fixed size path for the puma, no heap allocation inside the decomposition
+    Eigen::Matrix< double, 6, 6 > mat = Eigen::Matrix< double, 6, 6 >::Identity();
+    mat.col(0) = v.normalized();
+    this->basisQr6.compute(mat);
+    Q = this->basisQr6.householderQ();
+  }
+  else
+  {
+    Eigen::MatrixXd mat = Eigen::MatrixXd::Identity(dim, dim);
+    mat.col(0) = v.normalized();
+    this->basisQr.compute(mat);
+    Q = this->basisQr.householderQ();
+  }
 
-  // Extract the Q matrix from the QR decomposition. Q is an orthonormal matrix where columns are the orthonormal basis vectors.
-  Eigen::MatrixXd Q = qr.householderQ();
+  // Householder QR only determines the columns up to sign, make sure the
+  // first column points from start to goal and not the other way around.
+  if (Q.col(0).dot(v) < 0)
+  {
+    Q.col(0) = -Q.col(0);
+  }
 
-  // Return the Q matrix, which now contains an orthonormal basis for the space.
+  // Q now contains an orthonormal basis for the space.
   // The first vector is the normalized input vector, and the rest are orthogonal to it and each other.
+  if (this->verbose_basis)
+  {
+    std::cout << "Orthonormal basis:\n" << Q << std::endl;
+  }
 
-  std::cout << "Orthonormal basis:\n" << Q << std::endl;
+  return Q;
+}
 
-  /*
-  for (int i = 1; i < dim; ++i) {
-    float diff = Q.col(i-1).dot(Q.col(i));
-    std::cout << "Diff from perfect orthogonality:" << i << "="<< diff << std::endl;
+void
+YourPlanner::updateBasis()
+{
+  if (this->basisStart.size() == this->start->size() && this->basisStart == *this->start &&
+      this->basisGoal.size() == this->goal->size() && this->basisGoal == *this->goal)
+  {
+    return;
   }
-  */
-  
-  return Q;
+
+  //calculate direction in c-space from start to goal
+  Eigen::VectorXd start_to_goal = (*this->goal) - (*this->start);
+
+  //calculate length between start and goal
+  this->lengthStartGoal = start_to_goal.norm();
+
+  //calculate orthonormal basis including the first direction as the 0th entry
+  this->Q = this->generateOrthonormalBasis(start_to_goal);
+
+  this->basisStart = *this->start;
+  this->basisGoal = *this->goal;
 }
 
 
 YourPlanner::Vertex
 YourPlanner::extend(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen)
 {
+  TRACE_SCOPE("extend", "collision");
   ::rl::math::Real distance = nearest.second;
   ::rl::math::Real step = (::std::min)(distance, this->delta);
 
@@ -286,6 +429,11 @@ YourPlanner::getNumEdges() const
     edges += ::boost::num_edges(this->tree[i]);
   }
 
+  for (::std::list< Tree >::const_iterator i = this->local.begin(); i != this->local.end(); ++i)
+  {
+    edges += ::boost::num_edges(*i);
+  }
+
   return edges;
 }
 
@@ -299,12 +447,80 @@ YourPlanner::getNumVertices() const
     vertices += ::boost::num_vertices(this->tree[i]);
   }
 
+  for (::std::list< Tree >::const_iterator i = this->local.begin(); i != this->local.end(); ++i)
+  {
+    vertices += ::boost::num_vertices(*i);
+  }
+
   return vertices;
 }
 
+::std::size_t
+YourPlanner::getVertexMemory() const
+{
+  ::std::size_t dof = NULL != this->model ? this->model->getDof() : 0;
+
+  // make_shared puts the reference counts next to the vector, its coefficients are a block of their own
+  return node(sizeof(Tree::stored_vertex)) + chunk(2 * sizeof(void*) + sizeof(::rl::math::Vector)) + chunk(dof * sizeof(::rl::math::Real));
+}
+
+::std::size_t
+YourPlanner::getEdgeMemory() const
+{
+  // Source, target and the empty property in the edge list, target and edge list iterator in the out and in edges
+  return node(3 * sizeof(void*)) + 2 * node(2 * sizeof(void*));
+}
+
+::std::vector< ::std::size_t >
+YourPlanner::getTreeMemory() const
+{
+  ::std::vector< const Tree* > trees;
+
+  for (::std::size_t i = 0; i < this->tree.size(); ++i)
+  {
+    trees.push_back(&this->tree[i]);
+  }
+
+  for (::std::list< Tree >::const_iterator i = this->local.begin(); i != this->local.end(); ++i)
+  {
+    trees.push_back(&*i);
+  }
+
+  trees.push_back(&this->star);
+
+  ::std::vector< ::std::size_t > memory;
+  ::std::size_t vertex = this->getVertexMemory();
+  ::std::size_t edge = this->getEdgeMemory();
+
+  for (::std::size_t i = 0; i < trees.size(); ++i)
+  {
+    memory.push_back(::boost::num_vertices(*trees[i]) * vertex + ::boost::num_edges(*trees[i]) * edge);
+  }
+
+  return memory;
+}
+
+::std::size_t
+YourPlanner::getMemory() const
+{
+  ::std::vector< ::std::size_t > memory = this->getTreeMemory();
+  ::std::size_t total = 0;
+
+  for (::std::size_t i = 0; i < memory.size(); ++i)
+  {
+    total += memory[i];
+  }
+
+  return total;
+}
+
 rl::plan::VectorList
 YourPlanner::getPath()
 {
+  if (!this->bestPath.empty())
+  {
+    return this->bestPath;
+  }
 
   rl::plan::VectorList path;
   Vertex i = this->end[0];
@@ -339,15 +555,22 @@ YourPlanner::compute_distance(const ::rl::math::Vector& q1, const ::rl::math::Ve
 YourPlanner::Neighbor // TODO: OPTIMIZE
 YourPlanner::nearest(const Tree& tree, const ::rl::math::Vector& chosen)
 {
+  TRACE_SCOPE("nearest", "planner");
+
   //create an empty pair <Vertex, distance> to return
   Neighbor p(Vertex(), (::std::numeric_limits< ::rl::math::Real >::max)());
+  ::std::size_t skips = 0;
 
   //Iterate through all vertices to find the nearest neighbour
   for (VertexIteratorPair i = ::boost::vertices(tree); i.first != i.second; ++i.first)
   {
     //TODO: maybe only make them less likely?
     //ignore exhausted nodes
-    if (tree[*i.first].exhausted) continue;
+    if (tree[*i.first].exhausted)
+    {
+      ++skips;
+      continue;
+    }
 
     ::rl::math::Real d = this->compute_distance(chosen, *tree[*i.first].q);
 
@@ -362,6 +585,8 @@ YourPlanner::nearest(const Tree& tree, const ::rl::math::Vector& chosen)
   // Compute the square root of distance
   p.second = this->model->inverseOfTransformedDistance(p.second);
 
+  this->nearestSkips = skips;
+
   return p;
 }
 
@@ -370,20 +595,63 @@ YourPlanner::reset()
 {
   for (::std::size_t i = 0; i < this->tree.size(); ++i)
   {
-    this->tree[i].clear();
-    this->begin[i] = NULL;
+    // With warm start the trees are reattached to the next query in solve(), unless they grew too large to keep
+    if (!this->use_warm_start || ::boost::num_vertices(this->tree[i]) > this->warm_start_max_vertices)
+    {
+      this->tree[i].clear();
+      this->begin[i] = NULL;
+    }
+
     this->end[i] = NULL;
   }
+
+  this->local.clear();
+  this->resetClosest();
+  this->star.clear();
+  this->starIndex.clear();
+  this->starVertices.clear();
+  this->starGoal = NULL;
+  this->bestPath.clear();
+  this->best_cost = (::std::numeric_limits< ::rl::math::Real >::infinity)();
 }
 
 bool // TODO: OPTIMIZE
 YourPlanner::solve()
 {
+  TRACE_SCOPE("solve", "planner");
   this->sampler->setSigma(this->sigma);
+  // Also narrows the tube again that the previous query may have widened
+  this->sampler->setTubeSigma(this->tube_sigma);
+  this->sampler->maxAttempts = this->sampling_budget;
+  this->sampler->resetStats();
+  this->profile.reset();
+  this->domain_rejections = 0;
+  // delta is usually set after construction, so the domain bounds are resolved here
+  this->domainRadius = this->domain_radius_factor * this->delta;
+  this->domainMinRadius = (::std::min)(this->domain_min_radius_factor * this->delta, this->domainRadius);
+  this->cross_connect_attempts = 0;
+  this->cross_connect_successes = 0;
+  this->resetClosest();
+  if (this->use_workspace_sampling)
+  {
+    // End effector pose of the goal, the workspace sampler draws positions around it
+    this->model->setPosition(*this->goal);
+    this->model->updateFrames();
+    this->sampler->setWorkspaceTarget(this->model->forwardPosition());
+    this->sampler->workspaceSigma = this->workspace_sigma;
+  }
   this->time = ::std::chrono::steady_clock::now();
-  // Define the roots of both trees
-  this->begin[0] = this->addVertex(this->tree[0], ::std::make_shared< ::rl::math::Vector >(*this->start));
-  this->begin[1] = this->addVertex(this->tree[1], ::std::make_shared< ::rl::math::Vector >(*this->goal));
+  // Define the roots of both trees, or move the roots of the trees of the previous query
+  for (::std::size_t i = 0; i < 2; ++i)
+  {
+    const ::rl::math::Vector& root = 0 == i ? *this->start : *this->goal;
+
+    if (!this->use_warm_start || NULL == this->begin[i] || !this->reroot(this->tree[i], this->begin[i], root))
+    {
+      this->tree[i].clear();
+      this->begin[i] = this->addVertex(this->tree[i], ::std::make_shared< ::rl::math::Vector >(root));
+    }
+  }
 
 
 
@@ -392,14 +660,12 @@ YourPlanner::solve()
 
   ::rl::math::Vector chosen(this->model->getDof());
 
-  //calculate direction in c-space from start to goal
-  Eigen::VectorXd start_to_goal = (*this->goal) - (*this->start);
+  //orthonormal basis of the start-goal line, cached across queries with the same start and goal
+  this->updateBasis();
 
-  //calculate length between start and goal
-  this->lengthStartGoal = start_to_goal.norm();
-
-  //calculate orthonormal basis including the first direction as the 0th entry
-  this->Q = YourPlanner::generateOrthonormalBasis(start_to_goal);
+  //smallest distance between the two trees so far, used to detect when the tube sampler stalls
+  ::rl::math::Real bestGap = this->lengthStartGoal;
+  uint stalled = 0;
 
   while ((::std::chrono::steady_clock::now() - this->time) < this->duration)
   {
@@ -407,30 +673,108 @@ YourPlanner::solve()
     //then swap roles: first grow tree b and connect to a.
     for (::std::size_t j = 0; j < 2; ++j)
     {
+      TRACE_SCOPE("iteration", "planner");
+
       //Sample a random configuration
-      this->choose(chosen, &this->tree[0] == a ? *this->goal : *this->start);
+      SOLVE_PROFILE(PHASE_CHOOSE, this->choose(chosen, &this->tree[0] == a ? *this->goal : *this->start));
+
+      //Seed a local tree in a narrow passage now and then
+      if (this->use_local_trees && this->local.size() < this->max_local_trees &&
+          this->sampler->rand() < this->local_tree_probability)
+      {
+        SOLVE_PROFILE(PHASE_LOCAL_TREES, this->seedLocalTree());
+      }
 
       //Find the nearest neighbour in the tree
-      Neighbor aNearest = this->nearest(*a, chosen);
+      Neighbor aNearest = SOLVE_PROFILE(PHASE_NEAREST, this->nearest(*a, chosen));
+      SOLVE_PROFILE_ADD(exhaustedSkips, this->nearestSkips);
+
+      //Samples outside the domain of their nearest vertex would most likely collide right away
+      bool outside = this->use_dynamic_domain && aNearest.second > (*a)[aNearest.first].radius;
+
+      if (outside)
+      {
+        ++this->domain_rejections;
+      }
 
       //Do a CONNECT step from the nearest neighbour to the sample
-      Vertex aConnected = this->connect(*a, aNearest, chosen);
+      Vertex aConnected = outside ? NULL : SOLVE_PROFILE(PHASE_CONNECT, this->connect(*a, aNearest, chosen));
 
       //If a new node was inserted tree a
       if (NULL != aConnected)
       {
-        // Try a CONNECT step form the other tree to the sample
-        Neighbor bNearest = this->nearest(*b, *(*a)[aConnected].q);
-        Vertex bConnected = this->connect(*b, bNearest, *(*a)[aConnected].q);
+        // Let the local trees grow towards the new vertex, one that reaches it becomes part of tree a
+        if (this->use_local_trees)
+        {
+          SOLVE_PROFILE(PHASE_LOCAL_TREES, this->connectLocalTrees(*a, aConnected));
+        }
+
+        // Vertex of tree a that tree b tries to connect to
+        Vertex aEnd = aConnected;
+        Vertex bConnected = NULL;
+        ::rl::math::Real gap = (::std::numeric_limits< ::rl::math::Real >::infinity)();
+
+        // In gap tracking mode, a closest pair within the threshold that got closer since the last attempt is connected instead
+        if (this->use_gap_tracking && !this->closest.tried && this->closest.distance < this->gap_threshold)
+        {
+          ::std::size_t ia = &this->tree[0] == a ? 0 : 1;
+          aEnd = this->closest.vertex[ia];
+          Neighbor bNearest(this->closest.vertex[1 - ia], this->closest.distance);
+          this->closest.tried = true;
+          ++this->cross_connect_attempts;
+          bConnected = SOLVE_PROFILE(PHASE_CROSS_CONNECT, this->connect(*b, bNearest, *(*a)[aEnd].q));
+          gap = this->closest.distance;
+        }
+        else
+        {
+          // Try a CONNECT step form the other tree to the sample, also while the tracked pair is blocked or too far apart
+          SOLVE_PROFILE_SCOPE(PHASE_CROSS_CONNECT);
+          Neighbor bNearest = this->nearest(*b, *(*a)[aConnected].q);
+          SOLVE_PROFILE_ADD(exhaustedSkips, this->nearestSkips);
+          ++this->cross_connect_attempts;
+          bConnected = this->connect(*b, bNearest, *(*a)[aConnected].q);
+          gap = NULL != bConnected ? this->model->distance(*(*a)[aConnected].q, *(*b)[bConnected].q) : bNearest.second;
+        }
+
+        if (this->use_gaussian_along_c_path)
+        {
+          if (gap < bestGap)
+          {
+            bestGap = gap;
+            stalled = 0;
+          }
+          else if (++stalled > this->tube_stall_limit)
+          {
+            this->sampler->widenTube(this->tube_widen_factor);
+            stalled = 0;
+          }
+        }
 
         if (NULL != bConnected)
         {
           //Test if we could connect both trees with each other
-          if (this->areEqual(*(*a)[aConnected].q, *(*b)[bConnected].q))
+          if (this->areEqual(*(*a)[aEnd].q, *(*b)[bConnected].q))
           {
-            this->end[0] = &this->tree[0] == a ? aConnected : bConnected;
-            this->end[1] = &this->tree[1] == b ? bConnected : aConnected;
-            return true;
+            ++this->cross_connect_successes;
+            this->end[0] = &this->tree[0] == a ? aEnd : bConnected;
+            this->end[1] = &this->tree[1] == b ? bConnected : aEnd;
+
+            // In a changing scene edges kept from earlier queries are only checked once they are part of a solution,
+            // an invalid one was removed and the trees keep alternating below
+            if (this->use_warm_start && this->use_warm_start_validation && !this->validatePath())
+            {
+              this->end[0] = NULL;
+              this->end[1] = NULL;
+            }
+            else
+            {
+              if (this->use_anytime)
+              {
+                this->improve();
+              }
+
+              return true;
+            }
           }
         }
       }
@@ -442,4 +786,445 @@ YourPlanner::solve()
 
   }
   return false;
-}
\ No newline at end of file
+}
+
+bool
+YourPlanner::seedLocalTree()
+{
+  // Seeds have their own budget, the sampling budget of the planner may be unbounded
+  ::std::size_t maxAttempts = this->sampler->maxAttempts;
+  this->sampler->maxAttempts = this->local_tree_attempts;
+
+  ::std::size_t fallbacks = this->sampler->bridgeStats.fallbacks;
+  ::rl::math::Vector q = this->sampler->generateBridge();
+
+  this->sampler->maxAttempts = maxAttempts;
+
+  // A uniform fallback sample is not in a narrow passage
+  if (this->sampler->bridgeStats.fallbacks != fallbacks)
+  {
+    return false;
+  }
+
+  this->local.push_back(Tree());
+  this->addVertex(this->local.back(), ::std::make_shared< ::rl::math::Vector >(q));
+
+  return true;
+}
+
+void
+YourPlanner::connectLocalTrees(Tree& target, const Vertex& v)
+{
+  const ::rl::math::Vector& q = *target[v].q;
+
+  for (::std::list< Tree >::iterator i = this->local.begin(); i != this->local.end(); ++i)
+  {
+    Neighbor n = this->nearest(*i, q);
+    Vertex connected = this->connect(*i, n, q);
+
+    if (NULL != connected && this->areEqual(*(*i)[connected].q, q))
+    {
+      this->merge(*i, connected, target, v);
+      this->local.erase(i);
+      return;
+    }
+  }
+}
+
+void
+YourPlanner::merge(const Tree& source, const Vertex& sourceVertex, Tree& target, const Vertex& targetVertex)
+{
+  // Breadth first from sourceVertex ignoring edge directions, so all edges point away from it in target
+  ::std::map< Vertex, Vertex > copies;
+  ::std::vector< Vertex > open(1, sourceVertex);
+  copies[sourceVertex] = targetVertex;
+
+  for (::std::size_t i = 0; i < open.size(); ++i)
+  {
+    Vertex u = open[i];
+    ::std::vector< Vertex > neighbors;
+
+    for (::boost::graph_traits< Tree >::out_edge_iterator e = ::boost::out_edges(u, source).first; e != ::boost::out_edges(u, source).second; ++e)
+    {
+      neighbors.push_back(::boost::target(*e, source));
+    }
+
+    for (::boost::graph_traits< Tree >::in_edge_iterator e = ::boost::in_edges(u, source).first; e != ::boost::in_edges(u, source).second; ++e)
+    {
+      neighbors.push_back(::boost::source(*e, source));
+    }
+
+    for (::std::size_t j = 0; j < neighbors.size(); ++j)
+    {
+      if (copies.count(neighbors[j]) > 0)
+      {
+        continue;
+      }
+
+      Vertex copy = this->addVertex(target, source[neighbors[j]].q);
+      this->addEdge(copies[u], copy, target);
+      copies[neighbors[j]] = copy;
+      open.push_back(neighbors[j]);
+    }
+  }
+}
+
+bool
+YourPlanner::reroot(Tree& tree, Vertex& root, const ::rl::math::Vector& q)
+{
+  if (this->areEqual(*tree[root].q, q))
+  {
+    return true;
+  }
+
+  Neighbor n = this->nearest(tree, q);
+
+  if (!this->isEdgeFree(q, *tree[n.first].q))
+  {
+    return false;
+  }
+
+  // Failures towards the previous samples say little about the next query, and in a changing scene
+  // everything kept is only trusted after it was checked again
+  for (VertexIteratorPair i = ::boost::vertices(tree); i.first != i.second; ++i.first)
+  {
+    tree[*i.first].exhausted = false;
+    tree[*i.first].fails = 0;
+    tree[*i.first].successes = 0;
+    tree[*i.first].radius = (::std::numeric_limits< ::rl::math::Real >::infinity)();
+    tree[*i.first].stale = this->use_warm_start_validation;
+  }
+
+  // Reverse the edges between the nearest vertex and the old root, so that it becomes the parent of the old root
+  ::std::vector< Vertex > branch(1, n.first);
+
+  while (branch.back() != root)
+  {
+    branch.push_back(::boost::source(*::boost::in_edges(branch.back(), tree).first, tree));
+  }
+
+  for (::std::size_t i = 1; i < branch.size(); ++i)
+  {
+    ::boost::remove_edge(branch[i], branch[i - 1], tree);
+    ::boost::add_edge(branch[i - 1], branch[i], tree);
+  }
+
+  root = this->addVertex(tree, ::std::make_shared< ::rl::math::Vector >(q));
+  this->addEdge(root, n.first, tree);
+  tree[n.first].stale = false;
+
+  return true;
+}
+
+void
+YourPlanner::prune(Tree& tree, const Vertex& v)
+{
+  ::std::vector< Vertex > open(1, v);
+  ::std::vector< Vertex > subtree;
+
+  while (!open.empty())
+  {
+    Vertex u = open.back();
+    open.pop_back();
+    subtree.push_back(u);
+
+    for (::boost::graph_traits< Tree >::out_edge_iterator e = ::boost::out_edges(u, tree).first; e != ::boost::out_edges(u, tree).second; ++e)
+    {
+      open.push_back(::boost::target(*e, tree));
+    }
+  }
+
+  for (::std::size_t i = 0; i < subtree.size(); ++i)
+  {
+    ::boost::clear_vertex(subtree[i], tree);
+    ::boost::remove_vertex(subtree[i], tree);
+  }
+
+  // The closest pair may have been removed
+  this->resetClosest();
+}
+
+bool
+YourPlanner::validatePath()
+{
+  for (::std::size_t t = 0; t < 2; ++t)
+  {
+    for (Vertex i = this->end[t]; i != this->begin[t]; )
+    {
+      Vertex parent = ::boost::source(*::boost::in_edges(i, this->tree[t]).first, this->tree[t]);
+
+      if (this->tree[t][i].stale)
+      {
+        if (!this->isEdgeFree(*this->tree[t][parent].q, *this->tree[t][i].q))
+        {
+          this->prune(this->tree[t], i);
+          return false;
+        }
+
+        this->tree[t][i].stale = false;
+      }
+
+      i = parent;
+    }
+  }
+
+  return true;
+}
+
+bool
+YourPlanner::isEdgeFree(const ::rl::math::Vector& a, const ::rl::math::Vector& b)
+{
+  ::rl::math::Real distance = this->model->distance(a, b);
+  ::std::size_t steps = static_cast< ::std::size_t >(::std::ceil(distance / this->delta));
+
+  ::rl::math::Vector q(this->model->getDof());
+
+  for (::std::size_t i = 1; i <= steps; ++i)
+  {
+    this->model->interpolate(a, b, static_cast< ::rl::math::Real >(i) / steps, q);
+    this->model->setPosition(q);
+    this->model->updateFrames();
+
+    if (this->model->isColliding())
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+::std::vector< YourPlanner::Neighbor >
+YourPlanner::kNearest(const ::rl::math::Vector& chosen, const ::std::size_t& k)
+{
+  ::std::vector< KdTree::Neighbor > found = this->starIndex.nearest(chosen, k);
+  ::std::vector< Neighbor > neighbors;
+  neighbors.reserve(found.size());
+
+  for (::std::size_t i = 0; i < found.size(); ++i)
+  {
+    neighbors.push_back(Neighbor(this->starVertices[found[i].first], found[i].second));
+  }
+
+  return neighbors;
+}
+
+void
+YourPlanner::indexStar(const Vertex& v)
+{
+  this->starIndex.insert(*this->star[v].q, this->starVertices.size());
+  this->starVertices.push_back(v);
+}
+
+void
+YourPlanner::rewire(Tree& tree, const Vertex& v, const Vertex& parent, const ::rl::math::Real& cost)
+{
+  ::boost::clear_in_edges(v, tree);
+  this->addEdge(parent, v, tree);
+
+  // Propagate the cost change to all descendants
+  ::rl::math::Real change = cost - tree[v].cost;
+  ::std::vector< Vertex > open(1, v);
+
+  while (!open.empty())
+  {
+    Vertex u = open.back();
+    open.pop_back();
+    tree[u].cost += change;
+
+    for (::boost::graph_traits< Tree >::out_edge_iterator e = ::boost::out_edges(u, tree).first; e != ::boost::out_edges(u, tree).second; ++e)
+    {
+      open.push_back(::boost::target(*e, tree));
+    }
+  }
+}
+
+void
+YourPlanner::seedStar()
+{
+  this->star.clear();
+
+  // Copy the start tree, its edges were checked by connect()
+  ::std::map< Vertex, Vertex > copies;
+  ::std::vector< Vertex > open(1, this->begin[0]);
+
+  Vertex root = ::boost::add_vertex(this->star);
+  this->star[root].index = 0;
+  this->star[root].q = this->tree[0][this->begin[0]].q;
+  this->star[root].cost = 0;
+  copies[this->begin[0]] = root;
+
+  while (!open.empty())
+  {
+    Vertex u = open.back();
+    open.pop_back();
+
+    for (::boost::graph_traits< Tree >::out_edge_iterator e = ::boost::out_edges(u, this->tree[0]).first; e != ::boost::out_edges(u, this->tree[0]).second; ++e)
+    {
+      Vertex v = ::boost::target(*e, this->tree[0]);
+      Vertex copy = ::boost::add_vertex(this->star);
+      this->star[copy].index = ::boost::num_vertices(this->star) - 1;
+      this->star[copy].q = this->tree[0][v].q;
+      this->star[copy].cost = this->star[copies[u]].cost + this->model->distance(*this->tree[0][u].q, *this->tree[0][v].q);
+      ::boost::add_edge(copies[u], copy, this->star);
+      copies[v] = copy;
+      open.push_back(v);
+    }
+  }
+
+  // Append the branch of the goal tree from the connection to the goal
+  Vertex last = copies[this->end[0]];
+  Vertex i = this->end[1];
+
+  while (i != this->begin[1])
+  {
+    i = ::boost::source(*::boost::in_edges(i, this->tree[1]).first, this->tree[1]);
+
+    Vertex copy = ::boost::add_vertex(this->star);
+    this->star[copy].index = ::boost::num_vertices(this->star) - 1;
+    this->star[copy].q = this->tree[1][i].q;
+    this->star[copy].cost = this->star[last].cost + this->model->distance(*this->star[last].q, *this->tree[1][i].q);
+    ::boost::add_edge(last, copy, this->star);
+    last = copy;
+  }
+
+  this->starGoal = last;
+
+  this->starIndex.clear();
+  this->starVertices.clear();
+
+  for (VertexIteratorPair v = ::boost::vertices(this->star); v.first != v.second; ++v.first)
+  {
+    this->indexStar(*v.first);
+  }
+}
+
+::rl::plan::VectorList
+YourPlanner::getStarPath() const
+{
+  ::rl::plan::VectorList path;
+  Vertex i = this->starGoal;
+
+  while (::boost::in_degree(i, this->star) > 0)
+  {
+    path.push_front(*this->star[i].q);
+    i = ::boost::source(*::boost::in_edges(i, this->star).first, this->star);
+  }
+
+  path.push_front(*this->star[i].q);
+
+  return path;
+}
+
+void
+YourPlanner::improve()
+{
+  TRACE_SCOPE("improve", "planner");
+  ::std::chrono::steady_clock::time_point deadline = (::std::min)(
+    this->time + this->duration,
+    ::std::chrono::steady_clock::now() + this->anytime_duration
+  );
+
+  this->seedStar();
+  this->bestPath = this->getStarPath();
+  this->best_cost = this->star[this->starGoal].cost;
+
+  if (this->on_improvement)
+  {
+    this->on_improvement(this->bestPath, this->best_cost);
+  }
+
+  ::std::size_t dim = this->model->getDof();
+
+  // k_RRG = e (1 + 1 / d), Karaman and Frazzoli 2011
+  ::rl::math::Real kRrg = ::std::exp(1.0) * (1 + 1.0 / dim);
+
+  ::rl::math::Vector chosen(dim);
+
+  // delta is usually set after construction, so the step is resolved here
+  ::rl::math::Real step = this->anytime_step_factor * this->delta;
+
+  while (::std::chrono::steady_clock::now() < deadline)
+  {
+    // Samples outside the informed set cannot shorten the current path
+    if (this->use_informed_sampling)
+    {
+      chosen = this->sampler->generateInformed(this->Q, *this->start, *this->goal, this->best_cost);
+    }
+    else
+    {
+      chosen = this->sampler->generate();
+    }
+
+    Neighbor n = this->kNearest(chosen, 1).front();
+
+    if (n.second <= this->epsilon)
+    {
+      continue;
+    }
+
+    // Steer at most step towards the sample
+    ::rl::plan::VectorPtr q = ::std::make_shared< ::rl::math::Vector >(dim);
+    this->model->interpolate(*this->star[n.first].q, chosen, (::std::min)(static_cast< ::rl::math::Real >(1), step / n.second), *q);
+
+    if (!this->isEdgeFree(*this->star[n.first].q, *q))
+    {
+      continue;
+    }
+
+    ::std::size_t k = static_cast< ::std::size_t >(::std::ceil(kRrg * ::std::log(static_cast< ::rl::math::Real >(::boost::num_vertices(this->star)))));
+    ::std::vector< Neighbor > neighbors = this->kNearest(*q, k);
+
+    // Choose the parent with the lowest cost, candidates are checked cheapest first
+    ::std::sort(neighbors.begin(), neighbors.end(), [this](const Neighbor& lhs, const Neighbor& rhs) {
+      return this->star[lhs.first].cost + lhs.second < this->star[rhs.first].cost + rhs.second;
+    });
+
+    Vertex parent = n.first;
+    ::rl::math::Real cost = this->star[n.first].cost + this->model->distance(*this->star[n.first].q, *q);
+
+    for (::std::size_t i = 0; i < neighbors.size(); ++i)
+    {
+      ::rl::math::Real c = this->star[neighbors[i].first].cost + neighbors[i].second;
+
+      if (c >= cost)
+      {
+        break;
+      }
+
+      if (this->isEdgeFree(*this->star[neighbors[i].first].q, *q))
+      {
+        parent = neighbors[i].first;
+        cost = c;
+        break;
+      }
+    }
+
+    Vertex v = this->addVertex(this->star, q);
+    this->indexStar(v);
+    this->star[v].cost = cost;
+    this->addEdge(parent, v, this->star);
+
+    // Rewire neighbours through the new vertex if that is shorter
+    for (::std::size_t i = 0; i < neighbors.size(); ++i)
+    {
+      Vertex x = neighbors[i].first;
+
+      if (x != parent && cost + neighbors[i].second < this->star[x].cost && this->isEdgeFree(*q, *this->star[x].q))
+      {
+        this->rewire(this->star, x, v, cost + neighbors[i].second);
+      }
+    }
+
+    if (this->star[this->starGoal].cost < this->best_cost - this->epsilon)
+    {
+      this->best_cost = this->star[this->starGoal].cost;
+      this->bestPath = this->getStarPath();
+
+      if (this->on_improvement)
+      {
+        this->on_improvement(this->bestPath, this->best_cost);
+      }
+    }
+  }
+}
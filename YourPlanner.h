@@ -15,7 +15,13 @@
 #include <rl/plan/TransformPtr.h>
 #include <rl/plan/VectorPtr.h>
 #include <rl/plan/Verifier.h>
+#include "KdTree.h"
+#include "SolveProfile.h"
 #include "YourSampler.h"
+#include <Eigen/Dense>
+#include <functional>
+#include <limits>
+#include <list>
 
 using namespace ::rl::plan;
 /**
@@ -35,6 +41,19 @@ public:
 
   virtual ::std::size_t getNumVertices() const;
 
+  /** Estimated heap bytes of one vertex: its list node with the bundle and edge lists, and the shared configuration with its coefficients,
+      assuming glibc malloc and libstdc++ list nodes */
+  ::std::size_t getVertexMemory() const;
+
+  /** Estimated heap bytes of one edge: its node in the edge list, and its entries in the out and in edges of its ends */
+  ::std::size_t getEdgeMemory() const;
+
+  /** Estimated heap bytes of tree[0], tree[1], the local trees and the anytime tree, in this order */
+  ::std::vector< ::std::size_t > getTreeMemory() const;
+
+  /** Estimated heap bytes of all trees */
+  ::std::size_t getMemory() const;
+
   virtual rl::plan::VectorList getPath();
 
   virtual void reset();
@@ -63,10 +82,71 @@ public:
   bool use_better_connect = false;
   bool use_weighted_distance_metric = false;
   bool use_gaussian_along_c_path = false;
+  bool use_workspace_sampling = false;
+  /** Keep shortening the first solution with RRT* rewiring until anytime_duration or the deadline */
+  bool use_anytime = false;
+  /** Keep the trees across reset() and reattach them to the next start and goal */
+  bool use_warm_start = false;
+  /** The scene may change between queries: check the kept edges of a solution again before returning it */
+  bool use_warm_start_validation = false;
+  /** Trees with more vertices are cleared by reset() even with warm start */
+  ::std::size_t warm_start_max_vertices = 20000;
+  /** Dynamic-domain RRT: reject samples outside the sampling radius of their nearest vertex */
+  bool use_dynamic_domain = false;
+  /** Sample only where a shorter path can exist once there is a solution, used by the anytime mode */
+  bool use_informed_sampling = true;
+  /** Grow additional local trees from bridge samples in narrow passages, merged into the tree they connect to */
+  bool use_local_trees = false;
+  /** Maximum number of local trees at the same time */
+  uint max_local_trees = 4;
+  /** Probability per iteration of seeding a new local tree */
+  float local_tree_probability = 0.05;
+  /** Bridge test attempts per local tree seed, a seed without a narrow passage within them is dropped */
+  ::std::size_t local_tree_attempts = 100;
+  /** Track the closest pair of vertices between start and goal tree and connect it whenever it gets closer, otherwise connect as usual */
+  bool use_gap_tracking = false;
+  /** Closest pairs further apart than this are not tried first, the trees connect as usual instead; infinite tries every new pair */
+  ::rl::math::Real gap_threshold = (::std::numeric_limits< ::rl::math::Real >::infinity)();
+  /** New vertices are only compared with the tracked pair, every gap_refresh_interval-th one (at least 1) searches the whole other tree */
+  ::std::size_t gap_refresh_interval = 50;
+  /** Connect attempts between start and goal tree during the last solve() */
+  ::std::size_t cross_connect_attempts = 0;
+  /** Connect attempts between start and goal tree that joined them */
+  ::std::size_t cross_connect_successes = 0;
+  /** Time and collision queries per phase of the last solve(), only collected with TUTORIAL_PLAN_PROFILE */
+  SolveProfile profile;
   int exhaustion_limit = 50;
   float goal_bias = 0.05;
   ::rl::math::Real sigma = 0.1;
+  /** Standard deviation of the start-goal tube as a fraction of each joint range */
+  ::rl::math::Real tube_sigma = 0.05;
+  /** Factor the tube is widened by when the gap between the trees stops shrinking */
+  ::rl::math::Real tube_widen_factor = 1.5;
+  /** Iterations without a smaller gap between the trees before the tube is widened */
+  uint tube_stall_limit = 200;
+  /** Standard deviation of end effector positions around the goal pose [m] */
+  ::rl::math::Real workspace_sigma = 0.1;
+  /** Candidate samples per gaussian/bridge sample before falling back to uniform sampling, 0 is unbounded */
+  uint sampling_budget = 0;
+  /** Time spent improving the first solution in anytime mode, bounded by duration */
+  ::std::chrono::steady_clock::duration anytime_duration = ::std::chrono::seconds(5);
+  /** Maximum distance a new vertex is steered towards a sample in anytime mode, as a multiple of delta */
+  ::rl::math::Real anytime_step_factor = 10;
+  /** Called with the new path and its length whenever anytime mode finds a shorter path, unset by default */
+  ::std::function< void(const ::rl::plan::VectorList&, ::rl::math::Real) > on_improvement;
+  /** Length of the best path found by the last solve(), infinite if there is none */
+  ::rl::math::Real best_cost;
+  /** Radius a vertex gets on its first connect failure in dynamic-domain mode, as a multiple of delta */
+  ::rl::math::Real domain_radius_factor = 30;
+  /** Relative shrinking on connect failure and growing on success of the domain radius */
+  ::rl::math::Real domain_alpha = 0.05;
+  /** Lower bound of the domain radius, as a multiple of delta */
+  ::rl::math::Real domain_min_radius_factor = 2;
+  /** Samples rejected by the dynamic domain during the last solve() */
+  ::std::size_t domain_rejections = 0;
   ::std::string name = "Test";//"GoalProbability" + ::std::to_string(goal_bias);
+  /** Print the orthonormal basis whenever it is recomputed */
+  bool verbose_basis = false;
   Eigen::MatrixXd Q;
   double lengthStartGoal;
 
@@ -89,6 +169,15 @@ protected:
     bool exhausted = false;
     uint fails = 0;
     uint successes = 0;
+
+    /** Path length from the root, only maintained by the anytime mode */
+    ::rl::math::Real cost = 0;
+
+    /** Sampling radius in dynamic-domain mode, infinite until the first connect failure */
+    ::rl::math::Real radius = (::std::numeric_limits< ::rl::math::Real >::infinity)();
+
+    /** The edge from the parent was kept from an earlier query and has not been checked again, only with warm start validation */
+    bool stale = false;
   };
 
   typedef ::boost::adjacency_list_traits<
@@ -120,6 +209,20 @@ protected:
 
   typedef ::std::pair< Vertex, ::rl::math::Real > Neighbor;
 
+  /** Closest known pair of vertices between tree[0] and tree[1] */
+  struct ClosestPair
+  {
+    Vertex vertex[2];
+
+    ::rl::math::Real distance;
+
+    /** A connect between the pair was already attempted */
+    bool tried;
+
+    /** Vertices added since the last search of the whole other tree */
+    ::std::size_t insertions;
+  };
+
   ////////////////////////////////////////////////////////////////////////
   // helper functions ////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////
@@ -153,6 +256,67 @@ protected:
   /**generates and orthonormal basis based on a given vector that will be included (in normalized form) in said basis*/
   Eigen::MatrixXd generateOrthonormalBasis(const Eigen::VectorXd& v);
 
+  /** Recomputes Q and lengthStartGoal only if start or goal changed since the last call */
+  void updateBasis();
+
+  /** Updates closest with the new vertex v of tree[0] or tree[1] */
+  void updateClosest(const Tree& tree, const Vertex& v);
+
+  /** Forgets the closest pair */
+  void resetClosest();
+
+  ////////////////////////////////////////////////////////////////////////
+  // local trees /////////////////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////
+
+  /** Adds a local tree rooted at a bridge sample, returns false if the bridge sampler fell back to uniform sampling */
+  bool seedLocalTree();
+
+  /** Grows the local trees towards q, merges the first one that reaches it into target at vertex v */
+  void connectLocalTrees(Tree& target, const Vertex& v);
+
+  /** Copies source into target, re-rooted at sourceVertex which coincides with targetVertex */
+  void merge(const Tree& source, const Vertex& sourceVertex, Tree& target, const Vertex& targetVertex);
+
+  ////////////////////////////////////////////////////////////////////////
+  // warm start //////////////////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////
+
+  /** Attaches q to the nearest vertex of tree and makes it the new root, returns false if the edge collides,
+      the exhaustion and the domain radius of the kept vertices are reset as they belong to the previous query */
+  bool reroot(Tree& tree, Vertex& root, const ::rl::math::Vector& q);
+
+  /** Checks the stale edges of the solution, prunes the subtree below the first invalid one */
+  bool validatePath();
+
+  /** Removes v and all its descendants */
+  void prune(Tree& tree, const Vertex& v);
+
+  ////////////////////////////////////////////////////////////////////////
+  // anytime mode ////////////////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////
+
+  /** RRT* on a tree seeded with the start tree and the first solution, runs until the anytime deadline */
+  void improve();
+
+  /** Copies tree[0] and the goal branch of tree[1] along the solution into star */
+  void seedStar();
+
+  /** Checks the straight line between a and b in delta steps */
+  bool isEdgeFree(const ::rl::math::Vector& a, const ::rl::math::Vector& b);
+
+  /** Returns the k nearest neighbours of chosen in star from starIndex, sorted by distance */
+  ::std::vector< Neighbor > kNearest(const ::rl::math::Vector& chosen, const ::std::size_t& k);
+
+  /** Adds vertex v of star to starIndex */
+  void indexStar(const Vertex& v);
+
+  /** Replaces the parent of v and updates the cost of its subtree */
+  void rewire(Tree& tree, const Vertex& v, const Vertex& parent, const ::rl::math::Real& cost);
+
+  /** Path from the root of star to starGoal */
+  ::rl::plan::VectorList getStarPath() const;
+
   ////////////////////////////////////////////////////////////////////////
   // members /////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////
@@ -164,6 +328,38 @@ protected:
   ::std::vector< Vertex > begin;
   ::std::vector< Vertex > end;
 
+  /** Closest pair between the start and goal tree, maintained in gap tracking mode */
+  ClosestPair closest;
+
+  /** Local trees that have not been merged yet, a list so that merging does not move the others */
+  ::std::list< Tree > local;
+
+  /** Single tree rooted at start that anytime mode rewires, starGoal is the goal vertex in it */
+  Tree star;
+  Vertex starGoal;
+
+  /** Nearest neighbour index over star, ids are positions in starVertices */
+  KdTree starIndex;
+  ::std::vector< Vertex > starVertices;
+
+  /** Domain radius and its lower bound, resolved against delta at the start of solve() */
+  ::rl::math::Real domainRadius;
+  ::rl::math::Real domainMinRadius;
+
+  /** Exhausted vertices the last nearest() passed over, added to the profile by the solve loop only */
+  ::std::size_t nearestSkips;
+
+  /** Best path of the anytime mode, returned by getPath() if set */
+  ::rl::plan::VectorList bestPath;
+
+  /** Start and goal the cached basis Q was computed for */
+  ::rl::math::Vector basisStart;
+  ::rl::math::Vector basisGoal;
+
+  /** QR factors of the cached basis, fixed size for the 6 DOF puma */
+  Eigen::HouseholderQR< Eigen::Matrix< double, 6, 6 > > basisQr6;
+  Eigen::HouseholderQR< Eigen::MatrixXd > basisQr;
+
 private:
 
 };
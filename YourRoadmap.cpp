@@ -0,0 +1,376 @@
+#include "YourRoadmap.h"
+#include <rl/plan/Viewer.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include "MappedFile.h"
+
+namespace
+{
+  const char roadmapMagic[8] = {'R', 'L', 'R', 'O', 'A', 'D', 'M', 'P'};
+
+  const ::std::uint32_t roadmapVersion = 1;
+}
+
+YourRoadmap::YourRoadmap() :
+  Planner(),
+  delta(1.0f),
+  epsilon(1.0e-3f),
+  k(15),
+  batch(500),
+  sampler(NULL),
+  graph(),
+  index(),
+  path()
+{
+}
+
+YourRoadmap::~YourRoadmap()
+{
+}
+
+YourRoadmap::Vertex
+YourRoadmap::addMilestone(const ::rl::math::Vector& q)
+{
+  ::std::vector< KdTree::Neighbor > neighbors = this->index.nearest(q, this->k);
+
+  if (!neighbors.empty() && neighbors.front().second <= this->epsilon)
+  {
+    return neighbors.front().first;
+  }
+
+  Vertex v = ::boost::add_vertex(this->graph);
+  this->graph[v].q = ::std::make_shared< ::rl::math::Vector >(q);
+
+  if (NULL != this->viewer)
+  {
+    this->viewer->drawConfigurationVertex(q);
+  }
+
+  for (::std::size_t i = 0; i < neighbors.size(); ++i)
+  {
+    // Lazy: edges are only checked once a query needs them
+    Edge e = ::boost::add_edge(v, neighbors[i].first, this->graph).first;
+    this->graph[e].length = this->model->distance(q, *this->graph[neighbors[i].first].q);
+    this->graph[e].checked = false;
+  }
+
+  this->index.insert(q, v);
+
+  return v;
+}
+
+void
+YourRoadmap::clear()
+{
+  this->graph.clear();
+  this->index.clear();
+  this->path.clear();
+}
+
+bool
+YourRoadmap::findPath(const Vertex& u, const Vertex& v, ::std::vector< Vertex >& path)
+{
+  typedef ::std::pair< ::rl::math::Real, Vertex > Entry;
+
+  ::std::size_t n = ::boost::num_vertices(this->graph);
+  ::std::vector< ::rl::math::Real > cost(n, (::std::numeric_limits< ::rl::math::Real >::max)());
+  ::std::vector< Vertex > predecessor(n, u);
+  ::std::priority_queue< Entry, ::std::vector< Entry >, ::std::greater< Entry > > open;
+
+  cost[u] = 0;
+  open.push(Entry(this->model->distance(*this->graph[u].q, *this->graph[v].q), u));
+
+  while (!open.empty())
+  {
+    Vertex w = open.top().second;
+    open.pop();
+
+    if (w == v)
+    {
+      path.clear();
+
+      for (Vertex i = v; i != u; i = predecessor[i])
+      {
+        path.push_back(i);
+      }
+
+      path.push_back(u);
+      ::std::reverse(path.begin(), path.end());
+
+      return true;
+    }
+
+    for (::boost::graph_traits< Graph >::out_edge_iterator e = ::boost::out_edges(w, this->graph).first; e != ::boost::out_edges(w, this->graph).second; ++e)
+    {
+      Vertex x = ::boost::target(*e, this->graph);
+      ::rl::math::Real c = cost[w] + this->graph[*e].length;
+
+      if (c < cost[x])
+      {
+        cost[x] = c;
+        predecessor[x] = w;
+        open.push(Entry(c + this->model->distance(*this->graph[x].q, *this->graph[v].q), x));
+      }
+    }
+  }
+
+  return false;
+}
+
+::std::string
+YourRoadmap::getName() const
+{
+  return "LazyPRM";
+}
+
+::std::size_t
+YourRoadmap::getNumEdges() const
+{
+  return ::boost::num_edges(this->graph);
+}
+
+::std::size_t
+YourRoadmap::getNumVertices() const
+{
+  return ::boost::num_vertices(this->graph);
+}
+
+rl::plan::VectorList
+YourRoadmap::getPath()
+{
+  return this->path;
+}
+
+void
+YourRoadmap::grow(const ::std::size_t& n)
+{
+  for (::std::size_t i = 0; i < n; ++i)
+  {
+    this->addMilestone(this->sampler->generateCollisionFree());
+  }
+}
+
+bool
+YourRoadmap::isEdgeFree(const ::rl::math::Vector& a, const ::rl::math::Vector& b)
+{
+  ::rl::math::Real distance = this->model->distance(a, b);
+  ::std::size_t steps = static_cast< ::std::size_t >(::std::ceil(distance / this->delta));
+
+  ::rl::math::Vector q(this->model->getDof());
+
+  for (::std::size_t i = 1; i < steps; ++i)
+  {
+    this->model->interpolate(a, b, static_cast< ::rl::math::Real >(i) / steps, q);
+    this->model->setPosition(q);
+    this->model->updateFrames();
+
+    if (this->model->isColliding())
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+YourRoadmap::load(const ::std::string& filename, const ::std::uint64_t& fingerprint)
+{
+  MappedFile file;
+
+  if (!file.open(filename) || file.size() < sizeof(FileHeader))
+  {
+    return false;
+  }
+
+  FileHeader header;
+  ::std::memcpy(&header, file.data(), sizeof(FileHeader));
+
+  ::std::size_t dof = this->model->getDof();
+  ::std::size_t n = header.numVertices;
+  ::std::size_t m = header.numAdjacent;
+
+  if (0 != ::std::memcmp(header.magic, roadmapMagic, sizeof(roadmapMagic)) ||
+      header.version != roadmapVersion ||
+      header.realSize != sizeof(::rl::math::Real) ||
+      header.dof != dof ||
+      header.fingerprint != fingerprint ||
+      file.size() != sizeof(FileHeader) + n * dof * sizeof(::rl::math::Real) + (n + 1) * sizeof(::std::uint64_t) +
+        m * (sizeof(::std::uint64_t) + sizeof(::rl::math::Real) + sizeof(::std::uint8_t)))
+  {
+    return false;
+  }
+
+  // All sections are multiples of 8 bytes except the trailing flags, so the mapped arrays are aligned
+  const char* data = file.data() + sizeof(FileHeader);
+  const ::rl::math::Real* q = reinterpret_cast< const ::rl::math::Real* >(data);
+  data += n * dof * sizeof(::rl::math::Real);
+  const ::std::uint64_t* offsets = reinterpret_cast< const ::std::uint64_t* >(data);
+  data += (n + 1) * sizeof(::std::uint64_t);
+  const ::std::uint64_t* targets = reinterpret_cast< const ::std::uint64_t* >(data);
+  data += m * sizeof(::std::uint64_t);
+  const ::rl::math::Real* lengths = reinterpret_cast< const ::rl::math::Real* >(data);
+  data += m * sizeof(::rl::math::Real);
+  const ::std::uint8_t* checked = reinterpret_cast< const ::std::uint8_t* >(data);
+
+  this->clear();
+  this->graph = Graph(n);
+
+  for (::std::size_t v = 0; v < n; ++v)
+  {
+    this->graph[v].q = ::std::make_shared< ::rl::math::Vector >(::Eigen::Map< const ::rl::math::Vector >(q + v * dof, dof));
+    this->index.insert(*this->graph[v].q, v);
+
+    for (::std::uint64_t i = offsets[v]; i < offsets[v + 1]; ++i)
+    {
+      // Undirected, add every edge once from its smaller vertex
+      if (targets[i] > v && targets[i] < n)
+      {
+        Edge e = ::boost::add_edge(v, targets[i], this->graph).first;
+        this->graph[e].length = lengths[i];
+        this->graph[e].checked = 0 != checked[i];
+      }
+    }
+  }
+
+  return true;
+}
+
+void
+YourRoadmap::reset()
+{
+  this->path.clear();
+}
+
+bool
+YourRoadmap::save(const ::std::string& filename, const ::std::uint64_t& fingerprint) const
+{
+  ::std::size_t dof = this->model->getDof();
+  ::std::size_t n = ::boost::num_vertices(this->graph);
+
+  ::std::vector< ::rl::math::Real > q(n * dof);
+  ::std::vector< ::std::uint64_t > offsets(n + 1, 0);
+  ::std::vector< ::std::uint64_t > targets;
+  ::std::vector< ::rl::math::Real > lengths;
+  ::std::vector< ::std::uint8_t > checked;
+
+  for (Vertex v = 0; v < n; ++v)
+  {
+    ::std::copy(this->graph[v].q->data(), this->graph[v].q->data() + dof, q.begin() + v * dof);
+
+    for (::boost::graph_traits< Graph >::out_edge_iterator e = ::boost::out_edges(v, this->graph).first; e != ::boost::out_edges(v, this->graph).second; ++e)
+    {
+      targets.push_back(::boost::target(*e, this->graph));
+      lengths.push_back(this->graph[*e].length);
+      checked.push_back(this->graph[*e].checked ? 1 : 0);
+    }
+
+    offsets[v + 1] = targets.size();
+  }
+
+  FileHeader header;
+  ::std::memcpy(header.magic, roadmapMagic, sizeof(roadmapMagic));
+  header.version = roadmapVersion;
+  header.realSize = sizeof(::rl::math::Real);
+  header.dof = dof;
+  header.fingerprint = fingerprint;
+  header.numVertices = n;
+  header.numAdjacent = targets.size();
+
+  // Write next to the target and rename, the old file may still be mapped by another process
+  ::std::string tmp = filename + ".tmp";
+  ::std::ofstream out(tmp.c_str(), ::std::ios::binary | ::std::ios::trunc);
+
+  if (!out)
+  {
+    return false;
+  }
+
+  out.write(reinterpret_cast< const char* >(&header), sizeof(FileHeader));
+  out.write(reinterpret_cast< const char* >(q.data()), q.size() * sizeof(::rl::math::Real));
+  out.write(reinterpret_cast< const char* >(offsets.data()), offsets.size() * sizeof(::std::uint64_t));
+  out.write(reinterpret_cast< const char* >(targets.data()), targets.size() * sizeof(::std::uint64_t));
+  out.write(reinterpret_cast< const char* >(lengths.data()), lengths.size() * sizeof(::rl::math::Real));
+  out.write(reinterpret_cast< const char* >(checked.data()), checked.size() * sizeof(::std::uint8_t));
+  out.close();
+
+  if (!out)
+  {
+    ::std::remove(tmp.c_str());
+    return false;
+  }
+
+#ifdef _WIN32
+  // rename does not replace existing files on windows
+  ::std::remove(filename.c_str());
+#endif
+
+  return 0 == ::std::rename(tmp.c_str(), filename.c_str());
+}
+
+bool
+YourRoadmap::solve()
+{
+  this->time = ::std::chrono::steady_clock::now();
+  this->path.clear();
+
+  // Start and goal were verified by the caller and stay in the roadmap for later queries
+  Vertex start = this->addMilestone(*this->start);
+  Vertex goal = this->addMilestone(*this->goal);
+
+  ::std::vector< Vertex > vertices;
+
+  while ((::std::chrono::steady_clock::now() - this->time) < this->duration)
+  {
+    if (!this->findPath(start, goal, vertices))
+    {
+      this->grow(this->batch);
+      continue;
+    }
+
+    bool valid = true;
+
+    for (::std::size_t i = 1; i < vertices.size(); ++i)
+    {
+      Edge e = ::boost::edge(vertices[i - 1], vertices[i], this->graph).first;
+
+      if (this->graph[e].checked)
+      {
+        continue;
+      }
+
+      if (!this->isEdgeFree(*this->graph[vertices[i - 1]].q, *this->graph[vertices[i]].q))
+      {
+        ::boost::remove_edge(e, this->graph);
+        valid = false;
+        break;
+      }
+
+      this->graph[e].checked = true;
+
+      if (NULL != this->viewer)
+      {
+        this->viewer->drawConfigurationEdge(*this->graph[vertices[i - 1]].q, *this->graph[vertices[i]].q);
+      }
+    }
+
+    if (valid)
+    {
+      for (::std::size_t i = 0; i < vertices.size(); ++i)
+      {
+        this->path.push_back(*this->graph[vertices[i]].q);
+      }
+
+      return true;
+    }
+  }
+
+  return false;
+}
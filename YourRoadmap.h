@@ -0,0 +1,148 @@
+#ifndef _YOUR_ROADMAP_H_
+#define _YOUR_ROADMAP_H_
+
+#include <cstdint>
+#include <string>
+#include <boost/graph/adjacency_list.hpp>
+
+#include <rl/plan/Model.h>
+#include <rl/plan/Planner.h>
+#include <rl/plan/Sampler.h>
+#include <rl/plan/VectorPtr.h>
+
+#include "KdTree.h"
+
+/**
+*	Multi-query lazy probabilistic roadmap.
+*	The roadmap survives reset(), every solve() adds its start and goal as milestones
+*	and searches the graph. Edges are only collision checked once they are part of a
+*	shortest path, invalid ones are removed and the search is repeated. If start and
+*	goal are not connected, the roadmap grows by batch milestones.
+*
+*	R. Bohlin and L. E. Kavraki. Path planning using lazy PRM. ICRA 2000.
+*/
+class YourRoadmap : public rl::plan::Planner
+{
+public:
+  YourRoadmap();
+
+  virtual ~YourRoadmap();
+
+  virtual ::std::string getName() const;
+
+  virtual ::std::size_t getNumEdges() const;
+
+  virtual ::std::size_t getNumVertices() const;
+
+  virtual rl::plan::VectorList getPath();
+
+  /** Forgets the last path, the roadmap is kept */
+  virtual void reset();
+
+  virtual bool solve();
+
+  /** Drops the whole roadmap */
+  void clear();
+
+  /** Adds n collision free milestones, each with unchecked edges to its k nearest neighbours */
+  void grow(const ::std::size_t& n);
+
+  /**
+  *	Writes the roadmap in a binary format that load() can map without parsing:
+  *	Header, milestones as packed dof reals each, then the adjacency in CSR form
+  *	(numVertices + 1 offsets, targets, lengths, checked flags).
+  *	fingerprint identifies scene and kinematics the roadmap is valid for.
+  */
+  bool save(const ::std::string& filename, const ::std::uint64_t& fingerprint) const;
+
+  /**
+  *	Replaces the roadmap with the one in filename, fails if it was built for another scene, robot or build.
+  *	The graph and the index are rebuilt from the mapped arrays and the file is unmapped again,
+  *	which skips parsing but not copying: lazy checks remove edges and set their flags in place.
+  */
+  bool load(const ::std::string& filename, const ::std::uint64_t& fingerprint);
+
+  /////////////////////////////////////////////////////////////////////////
+  // Planner parameters ///////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  /** Configuration step size for edge checks. */
+  ::rl::math::Real delta;
+
+  /** Epsilon for configuration comparison. */
+  ::rl::math::Real epsilon;
+
+  /** Number of neighbours a new milestone is connected to */
+  ::std::size_t k;
+
+  /** Milestones added whenever start and goal are not connected */
+  ::std::size_t batch;
+
+  /** The sampler used for new milestones */
+  ::rl::plan::Sampler* sampler;
+
+protected:
+  struct VertexBundle
+  {
+    ::rl::plan::VectorPtr q;
+  };
+
+  struct EdgeBundle
+  {
+    ::rl::math::Real length;
+
+    /** Edge was collision checked and is free */
+    bool checked;
+  };
+
+  typedef ::boost::adjacency_list<
+  ::boost::listS,
+  ::boost::vecS,
+  ::boost::undirectedS,
+  VertexBundle,
+  EdgeBundle
+  > Graph;
+
+  typedef ::boost::graph_traits< Graph >::vertex_descriptor Vertex;
+
+  typedef ::boost::graph_traits< Graph >::edge_descriptor Edge;
+
+  struct FileHeader
+  {
+    char magic[8];
+
+    ::std::uint32_t version;
+
+    ::std::uint32_t realSize;
+
+    ::std::uint64_t dof;
+
+    ::std::uint64_t fingerprint;
+
+    ::std::uint64_t numVertices;
+
+    /** Adjacency entries, every edge is stored for both of its vertices */
+    ::std::uint64_t numAdjacent;
+  };
+
+  /** Adds q with unchecked edges to its k nearest milestones, reuses an existing milestone equal to q */
+  Vertex addMilestone(const ::rl::math::Vector& q);
+
+  /** A* from u to v, returns false if they are not connected */
+  bool findPath(const Vertex& u, const Vertex& v, ::std::vector< Vertex >& path);
+
+  /** Checks the straight line between a and b in delta steps */
+  bool isEdgeFree(const ::rl::math::Vector& a, const ::rl::math::Vector& b);
+
+  Graph graph;
+
+  /** Nearest neighbour index over all milestones, ids are vertex descriptors */
+  KdTree index;
+
+  rl::plan::VectorList path;
+
+private:
+
+};
+
+#endif // _YOUR_ROADMAP_H_
@@ -1,5 +1,8 @@
 #include <chrono>
+#include <cmath>
+#include <rl/kin/Puma.h>
 #include <rl/plan/SimpleModel.h>
+#include "Trace.h"
 #include "YourSampler.h"
 #include <iostream>
 
@@ -9,6 +12,18 @@ namespace rl
     {
         YourSampler::YourSampler() :
             Sampler(),
+            tubeScale(1),
+            tubeScaleMax(10),
+            workspaceTarget(::rl::math::Transform::Identity()),
+            workspaceSigma(0.1),
+            workspaceGoalBias(0.5),
+            workspaceReach(0.9),
+            workspaceIkFailures(0),
+            cache(NULL),
+            cacheProbability(0.25),
+            maxAttempts(0),
+            gaussianStats(),
+            bridgeStats(),
             randDistribution(0, 1),
             normalDistribution(0, 1),
             randEngine(::std::random_device()())
@@ -45,13 +60,34 @@ namespace rl
         ::rl::math::Vector
         YourSampler::generateGaussian()
         {
+            TRACE_SCOPE("generateGaussian", "sampler");
+
             ::rl::math::Vector sampleq(this->model->getDof());
             bool valid = false;
 
+            ++this->gaussianStats.calls;
+
+            if (this->drawCached(::SampleCache::KIND_BOUNDARY, sampleq))
+            {
+                return sampleq;
+            }
+
             ::rl::math::Vector maximum(this->model->getMaximum());
             ::rl::math::Vector minimum(this->model->getMinimum());
+
+            ::std::size_t attempts = 0;
             
             while(!valid){
+                if (this->maxAttempts > 0 && attempts >= this->maxAttempts)
+                {
+                    // Budget exhausted, e.g. in a nearly free scene
+                    this->gaussianStats.attempts += attempts;
+                    ++this->gaussianStats.fallbacks;
+                    return this->generate();
+                }
+
+                ++attempts;
+
                 // Generate Sample
                 for (::std::size_t i = 0; i < this->model->getDof(); ++i)
                 {
@@ -69,19 +105,48 @@ namespace rl
                 valid = this->model->isColliding();
             }
 
+            this->gaussianStats.attempts += attempts;
+            ++this->gaussianStats.accepted;
+
+            if (NULL != this->cache)
+            {
+                this->cache->add(::SampleCache::KIND_BOUNDARY, sampleq);
+            }
+
             return sampleq;
         }
 
         ::rl::math::Vector
         YourSampler::generateBridge()
         {
+            TRACE_SCOPE("generateBridge", "sampler");
+
             ::rl::math::Vector sampleq(this->model->getDof());
             bool valid = false;
 
+            ++this->bridgeStats.calls;
+
+            if (this->drawCached(::SampleCache::KIND_FREE, sampleq))
+            {
+                return sampleq;
+            }
+
             ::rl::math::Vector maximum(this->model->getMaximum());
             ::rl::math::Vector minimum(this->model->getMinimum());
-            
+
+            ::std::size_t attempts = 0;
+
             while(!valid){
+                if (this->maxAttempts > 0 && attempts >= this->maxAttempts)
+                {
+                    // Budget exhausted, e.g. in a nearly free scene
+                    this->bridgeStats.attempts += attempts;
+                    ++this->bridgeStats.fallbacks;
+                    return this->generate();
+                }
+
+                ++attempts;
+
                 // Generate Sample
                 for (::std::size_t i = 0; i < this->model->getDof(); ++i)
                 {
@@ -121,35 +186,155 @@ namespace rl
                 }
             }
 
+            this->bridgeStats.attempts += attempts;
+            ++this->bridgeStats.accepted;
+
+            if (NULL != this->cache)
+            {
+                this->cache->add(::SampleCache::KIND_FREE, sampleq);
+            }
+
             return sampleq;
         }
 
         ::rl::math::Vector
-        YourSampler::generateGaussianAlongCPath(const Eigen::MatrixXd& Q, const double lengthStartGoal)
+        YourSampler::generateGaussianAlongCPath(const Eigen::MatrixXd& Q, const ::rl::math::Vector& start, const double lengthStartGoal)
         {
+            TRACE_SCOPE("generateGaussianAlongCPath", "sampler");
+
             // Q.col(0) is the direction vector from "start" to "goal"
             // we multiply this by a random length in [0, length(start->goal)]
-            ::rl::math::Vector sampleq = Q.col(0) * (this->rand() * lengthStartGoal); // Initial point along A-B
-
+            ::rl::math::Vector sampleq = start + Q.col(0) * (this->rand() * lengthStartGoal); // Initial point along A-B
 
             for (int i = 1; i < Q.cols(); ++i)
             {
-                double gaussianSample = this->gauss(); // Gaussian sample for direction
-
-                //TODO add variance
+                // The tube covariance is diagonal in joint space (tubeSigma), projected onto
+                // the orthogonal directions this is the standard deviation along Q.col(i)
+                ::rl::math::Real sigmaI = Q.col(i).cwiseProduct(this->tubeSigma).norm() * this->tubeScale;
 
-                sampleq += Q.col(i) * gaussianSample; // Adjust position in each basis direction
+                sampleq += Q.col(i) * (this->gauss() * sigmaI); // Adjust position in each basis direction
             }
 
+            // The planner only needs the configuration, collision checking happens in connect()
             this->model->clip(sampleq); // Ensure within model limits
-            this->model->setPosition(sampleq);
-            this->model->updateFrames();
 
+            return sampleq;
+        }
+
+
+        ::rl::math::Vector
+        YourSampler::generateInformed(const Eigen::MatrixXd& Q, const ::rl::math::Vector& start, const ::rl::math::Vector& goal, const ::rl::math::Real cost)
+        {
+            TRACE_SCOPE("generateInformed", "sampler");
+
+            // Path costs come from the model metric, so does the focal distance
+            ::rl::math::Real minimumCost = this->model->distance(start, goal);
+
+            // Without a solution every sample can improve it
+            if (::std::isinf(cost) || cost <= minimumCost)
+            {
+                return this->generate();
+            }
+
+            ::std::size_t dof = this->model->getDof();
+
+            // Radii of the hyperspheroid, the transverse ones are all equal
+            ::rl::math::Vector radii = ::rl::math::Vector::Constant(dof, ::std::sqrt(cost * cost - minimumCost * minimumCost) / 2);
+            radii(0) = cost / 2;
+
+            ::rl::math::Vector center = (start + goal) / 2;
+            ::rl::math::Vector ball(dof);
+            ::rl::math::Vector sampleq(dof);
+
+            // Parts of the hyperspheroid may lie outside the joint limits, retry a few times before clipping
+            for (::std::size_t attempt = 0; attempt < 100; ++attempt)
+            {
+                // Uniform sample in the unit ball: gaussian direction, radius u^(1/n)
+                for (::std::size_t i = 0; i < dof; ++i)
+                {
+                    ball(i) = this->gauss();
+                }
+
+                ball *= ::std::pow(this->rand(), static_cast< ::rl::math::Real >(1) / dof) / ball.norm();
+
+                sampleq = center + Q * radii.cwiseProduct(ball);
+
+                if (this->model->isValid(sampleq))
+                {
+                    return sampleq;
+                }
+            }
+
+            this->model->clip(sampleq);
+
+            return sampleq;
+        }
+
+        ::rl::math::Vector
+        YourSampler::generateWorkspace()
+        {
+            TRACE_SCOPE("generateWorkspace", "sampler");
+
+            ::rl::kin::Puma* puma = dynamic_cast< ::rl::kin::Puma* >(this->model->kin);
+
+            // The analytic inverse kinematics only exists for the puma
+            if (NULL == puma)
+            {
+                return this->generate();
+            }
+
+            // Keep the orientation of the target and only sample the position
+            ::rl::math::Transform x = this->workspaceTarget;
+
+            if (this->rand() < this->workspaceGoalBias)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    x.translation()(i) += this->gauss() * this->workspaceSigma;
+                }
+            }
+            else
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    x.translation()(i) = puma->world().translation()(i) + (2 * this->rand() - 1) * this->workspaceReach;
+                }
+            }
+
+            // Pick one of the eight solution branches at random
+            puma->setArm(this->rand() < 0.5 ? ::rl::kin::Puma::ARM_LEFT : ::rl::kin::Puma::ARM_RIGHT);
+            puma->setElbow(this->rand() < 0.5 ? ::rl::kin::Puma::ELBOW_ABOVE : ::rl::kin::Puma::ELBOW_BELOW);
+            puma->setWrist(this->rand() < 0.5 ? ::rl::kin::Puma::WRIST_FLIP : ::rl::kin::Puma::WRIST_NONFLIP);
+
+            ::rl::math::Vector sampleq(this->model->getDof());
+
+            if (!puma->inversePosition(x, sampleq) || !this->model->isValid(sampleq))
+            {
+                // Unreachable or outside the joint limits
+                ++this->workspaceIkFailures;
+                return this->generate();
+            }
 
             return sampleq;
         }
 
 
+        bool
+        YourSampler::drawCached(const ::SampleCache::Kind& kind, ::rl::math::Vector& q)
+        {
+            // Only samples of previous runs are drawn, otherwise the first sample of a cold run would be repeated forever
+            if (NULL == this->cache || 0 == this->cache->sizeLoaded(kind) || this->rand() >= this->cacheProbability)
+            {
+                return false;
+            }
+
+            ::std::size_t size = this->cache->sizeLoaded(kind);
+            ::std::size_t i = (::std::min)(static_cast< ::std::size_t >(this->rand() * size), size - 1);
+            this->cache->get(kind, i, q);
+
+            return true;
+        }
+
         ::std::uniform_real_distribution< ::rl::math::Real>::result_type
         YourSampler::rand()
         {
@@ -178,6 +363,49 @@ namespace rl
                 this->sigma(i) = delta;
             }
         }
+
+        void
+        YourSampler::setTubeSigma(const ::rl::math::Real ratio)
+        {
+            ::rl::math::Vector maximum(this->model->getMaximum());
+            ::rl::math::Vector minimum(this->model->getMinimum());
+
+            this->tubeSigma = ratio * (maximum - minimum);
+            this->tubeScale = 1;
+        }
+
+        void
+        YourSampler::widenTube(const ::rl::math::Real factor)
+        {
+            this->tubeScale = (::std::min)(this->tubeScale * factor, this->tubeScaleMax);
+        }
+
+        void
+        YourSampler::resetStats()
+        {
+            this->gaussianStats = RejectionStats();
+            this->bridgeStats = RejectionStats();
+        }
+
+        YourSampler::RejectionStats::RejectionStats() :
+            calls(0),
+            attempts(0),
+            accepted(0),
+            fallbacks(0)
+        {
+        }
+
+        ::rl::math::Real
+        YourSampler::RejectionStats::attemptsPerAccepted() const
+        {
+            return 0 == this->accepted ? 0 : static_cast< ::rl::math::Real >(this->attempts) / this->accepted;
+        }
+
+        void
+        YourSampler::setWorkspaceTarget(const ::rl::math::Transform& target)
+        {
+            this->workspaceTarget = target;
+            this->workspaceIkFailures = 0;
+        }
     }
 }
-
@@ -2,9 +2,12 @@
 #define _YOURSAMPLER_H_
 
 
+#include <rl/math/Transform.h>
 #include <rl/plan/Sampler.h>
 #include <random>
 
+#include "SampleCache.h"
+
 namespace rl
 {
     namespace plan
@@ -15,6 +18,23 @@ namespace rl
         class YourSampler : public Sampler
         {
         public:
+            /** Counters of a rejection sampler, attempts are candidate samples drawn */
+            struct RejectionStats
+            {
+                RejectionStats();
+
+                ::rl::math::Real attemptsPerAccepted() const;
+
+                ::std::size_t calls;
+
+                ::std::size_t attempts;
+
+                ::std::size_t accepted;
+
+                /** Calls that ran out of maxAttempts and returned a uniform sample */
+                ::std::size_t fallbacks;
+            };
+
             YourSampler();
 
             virtual ~YourSampler();
@@ -22,16 +42,72 @@ namespace rl
             ::rl::math::Vector generate();
             ::rl::math::Vector generateGaussian();
             ::rl::math::Vector generateBridge();
-            ::rl::math::Vector generateGaussianAlongCPath(const Eigen::MatrixXd& Q, const double lengthAB);
+            ::rl::math::Vector generateGaussianAlongCPath(const Eigen::MatrixXd& Q, const ::rl::math::Vector& start, const double lengthStartGoal);
+            /** Samples uniformly in the prolate hyperspheroid of configurations q with |q - start| + |goal - q| <= cost, Q.col(0) points from start to goal */
+            ::rl::math::Vector generateInformed(const Eigen::MatrixXd& Q, const ::rl::math::Vector& start, const ::rl::math::Vector& goal, const ::rl::math::Real cost);
+            /** Samples an end effector position around workspaceTarget and maps it to joint space with the analytic puma inverse kinematics */
+            ::rl::math::Vector generateWorkspace();
 
 
             virtual void seed(const ::std::mt19937::result_type& value);
+
+            /** Uniform number in [0, 1) from the engine of this sampler, also drawn by the planner so that seeded runs repeat per sampler */
+            ::std::uniform_real_distribution< ::rl::math::Real>::result_type rand();
             void setSigma(const ::rl::math::Real delta);
+
+            /** Sets the per joint standard deviation of the start-goal tube to ratio * joint range, undoes any widening */
+            void setTubeSigma(const ::rl::math::Real ratio);
+            /** Multiplies the tube width by factor, up to tubeScaleMax */
+            void widenTube(const ::rl::math::Real factor);
+
+            void resetStats();
+
+            /** Sets the end effector pose generateWorkspace() samples around */
+            void setWorkspaceTarget(const ::rl::math::Transform& target);
             
             ::rl::math::Vector sigma;
 
+            /** Per joint standard deviation of the tube around the start-goal line */
+            ::rl::math::Vector tubeSigma;
+
+            /** Current widening of tubeSigma, 1 means not widened */
+            ::rl::math::Real tubeScale;
+
+            /** Upper bound for tubeScale */
+            ::rl::math::Real tubeScaleMax;
+
+            /** End effector pose generateWorkspace() samples around, usually the one of the goal */
+            ::rl::math::Transform workspaceTarget;
+
+            /** Standard deviation of the sampled end effector position around workspaceTarget [m] */
+            ::rl::math::Real workspaceSigma;
+
+            /** Probability of sampling around workspaceTarget instead of the whole reachable box */
+            ::rl::math::Real workspaceGoalBias;
+
+            /** Half edge length of the box around the robot base used for the other samples [m] */
+            ::rl::math::Real workspaceReach;
+
+            /** Number of workspace samples without inverse kinematics solution, these fall back to generate() */
+            ::std::size_t workspaceIkFailures;
+
+            /** Persistent gaussian and bridge samples, NULL disables caching */
+            ::SampleCache* cache;
+
+            /** Probability of drawing a sample loaded from the cache file instead of rejection sampling, below 1 so fresh samples keep being added */
+            ::rl::math::Real cacheProbability;
+
+            /** Candidate samples per generateGaussian()/generateBridge() call before falling back to generate(), 0 is unbounded */
+            ::std::size_t maxAttempts;
+
+            RejectionStats gaussianStats;
+
+            RejectionStats bridgeStats;
+
         protected:
-            ::std::uniform_real_distribution< ::rl::math::Real>::result_type rand();
+            /** Draws a random sample of kind from the cache, returns false if it should be generated instead */
+            bool drawCached(const ::SampleCache::Kind& kind, ::rl::math::Vector& q);
+
             ::std::normal_distribution< ::rl::math::Real>::result_type gauss();
 
             ::std::uniform_real_distribution< ::rl::math::Real> randDistribution;
@@ -370,10 +370,10 @@ QtWindow::load()
 {
 
     scene.reset(new rl::sg::so::Scene());
-    scene->load("../xml/rlsg/unimation-puma560-rbo_wall.xml");
+    scene->load(this->system->getSceneFile());
     rl::sg::so::Model* sceneModel = static_cast< rl::sg::so::Model* > (scene->getModel(0));
 
-    rl::kin::Kinematics* kinematics = rl::kin::Kinematics::create("../xml/rlkin/unimation-puma560.xml");
+    rl::kin::Kinematics* kinematics = rl::kin::Kinematics::create(this->system->getKinematicsFile());
     kinematics->world() = ::rl::math::AngleAxis(
                 90 * rl::math::DEG2RAD,
                 ::rl::math::Vector3::UnitZ());
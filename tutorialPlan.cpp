@@ -1,5 +1,6 @@
 #include <QApplication>
 #include <Inventor/Qt/SoQt.h>
+#include <iostream>
 
 #include "qt_visualization/QtWindow.h"
 #include "TutorialPlanSystem.h"
@@ -24,6 +25,12 @@ main(int argc, char** argv)
   //  Create the TutorialPlanSystem class which contains our roblib plan system.
   boost::shared_ptr<TutorialPlanSystem> system(new TutorialPlanSystem());
 
+  //  In anytime mode the planner keeps shortening its first solution, report every improvement.
+  system->getYourPlanner().on_improvement = [](const rl::plan::VectorList& path, rl::math::Real cost)
+  {
+    std::cout << "improved path: length " << cost << ", " << path.size() << " vertices" << std::endl;
+  };
+
   //  Create our main visualization window and pass our TutorialPlanSystem to the constructor.
   window = QtWindow::instance(system.get());
 
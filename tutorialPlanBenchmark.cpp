@@ -0,0 +1,345 @@
+#include <Inventor/SoDB.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+#include "PerfCounters.h"
+#include "Regression.h"
+#include "Trace.h"
+#include "TutorialPlanSystem.h"
+
+int
+usage(const char* name)
+{
+  std::cerr << "usage: " << name << " [--trials n] [--seed s] [--timeout seconds] [--config name]... [--scenario file]..." << std::endl;
+  std::cerr << "       " << name << " [--csv file] [--summary file] [--json file] [--trace file] [--perf] [--list]" << std::endl;
+  std::cerr << "       " << name << " --baseline trials.csv [--regressions file] [--regressions-csv file] [--alpha a] [--threshold t] [--scenario file]..." << std::endl;
+  return EXIT_FAILURE;
+}
+
+int
+main(int argc, char** argv)
+{
+  std::size_t trials = 10;
+  std::mt19937::result_type seed = 1;
+  double timeout = 60;
+  std::vector<std::string> names;
+  std::vector<std::string> scenarioFiles;
+  std::string csvFile = "benchmark_trials.csv";
+  std::string summaryFile = "benchmark_summary.csv";
+  std::string jsonFile = "benchmark.json";
+  std::string traceFile;
+  std::string baselineFile;
+  std::string regressionsFile = "benchmark_regressions.json";
+  std::string regressionsCsvFile = "benchmark_regressions.csv";
+  Regression regression;
+  bool perf = false;
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    bool value = i + 1 < argc;
+
+    if (value && std::strcmp(argv[i], "--trials") == 0)
+    {
+      trials = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (value && std::strcmp(argv[i], "--seed") == 0)
+    {
+      seed = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (value && std::strcmp(argv[i], "--timeout") == 0)
+    {
+      timeout = std::strtod(argv[++i], NULL);
+    }
+    else if (value && std::strcmp(argv[i], "--config") == 0)
+    {
+      names.push_back(argv[++i]);
+    }
+    else if (value && std::strcmp(argv[i], "--scenario") == 0)
+    {
+      scenarioFiles.push_back(argv[++i]);
+    }
+    else if (value && std::strcmp(argv[i], "--csv") == 0)
+    {
+      csvFile = argv[++i];
+    }
+    else if (value && std::strcmp(argv[i], "--summary") == 0)
+    {
+      summaryFile = argv[++i];
+    }
+    else if (value && std::strcmp(argv[i], "--json") == 0)
+    {
+      jsonFile = argv[++i];
+    }
+    else if (value && std::strcmp(argv[i], "--trace") == 0)
+    {
+      traceFile = argv[++i];
+    }
+    else if (value && std::strcmp(argv[i], "--baseline") == 0)
+    {
+      baselineFile = argv[++i];
+    }
+    else if (value && std::strcmp(argv[i], "--regressions") == 0)
+    {
+      regressionsFile = argv[++i];
+    }
+    else if (value && std::strcmp(argv[i], "--regressions-csv") == 0)
+    {
+      regressionsCsvFile = argv[++i];
+    }
+    else if (value && std::strcmp(argv[i], "--alpha") == 0)
+    {
+      regression.alpha = std::strtod(argv[++i], NULL);
+    }
+    else if (value && std::strcmp(argv[i], "--threshold") == 0)
+    {
+      regression.threshold = std::strtod(argv[++i], NULL);
+    }
+    else if (std::strcmp(argv[i], "--perf") == 0)
+    {
+      perf = true;
+    }
+    else if (std::strcmp(argv[i], "--list") == 0)
+    {
+      list = true;
+    }
+    else
+    {
+      return usage(argv[0]);
+    }
+  }
+
+  std::vector<BenchmarkConfiguration> available = Benchmark::defaultConfigurations();
+
+  if (list)
+  {
+    for (std::size_t i = 0; i < available.size(); ++i)
+    {
+      std::cout << available[i].name << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  //  The baseline decides what is rerun: its configurations, number of trials and seeds
+  std::vector<BenchmarkTrial> baseline;
+
+  if (!baselineFile.empty())
+  {
+    std::ifstream file(baselineFile.c_str());
+
+    if (!Benchmark::readTrials(file, baseline) || baseline.empty())
+    {
+      std::cerr << "cannot read baseline trials from " << baselineFile << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    names.clear();
+    trials = 0;
+    seed = baseline.front().seed;
+
+    for (std::size_t i = 0; i < baseline.size(); ++i)
+    {
+      if (std::find(names.begin(), names.end(), baseline[i].configuration) == names.end())
+      {
+        names.push_back(baseline[i].configuration);
+      }
+
+      trials = std::max(trials, baseline[i].trial + 1);
+      seed = std::min(seed, baseline[i].seed);
+    }
+  }
+
+  std::vector<BenchmarkConfiguration> configurations;
+
+  for (std::size_t i = 0; i < available.size(); ++i)
+  {
+    if (names.empty() || std::find(names.begin(), names.end(), available[i].name) != names.end())
+    {
+      configurations.push_back(available[i]);
+    }
+  }
+
+  if (configurations.empty())
+  {
+    std::cerr << "no configuration selected, see --list" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  //  Both shipped scenes by default
+  if (scenarioFiles.empty())
+  {
+    scenarioFiles.push_back("../scenarios/wall.txt");
+    scenarioFiles.push_back("../scenarios/boxes.txt");
+  }
+
+  if (!traceFile.empty())
+  {
+    if (!Trace::isEnabled())
+    {
+      std::cerr << "--trace needs a build with TUTORIAL_PLAN_TRACE" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    //  The ring buffer keeps the last spans of the run
+    Trace::start();
+  }
+
+  //  The trials run on this thread, so the counters are opened here once for all of them
+  PerfCounters counters;
+
+  if (perf && !counters.open())
+  {
+    std::cerr << "hardware counters are not available, see /proc/sys/kernel/perf_event_paranoid, continuing without them" << std::endl;
+  }
+
+  //  The scenes are read with coin, but nothing is shown
+  SoDB::init();
+
+  std::cerr << "build: " << Benchmark::getBuild() << std::endl;
+
+  std::vector<BenchmarkTrial> results;
+
+  for (std::size_t i = 0; i < scenarioFiles.size(); ++i)
+  {
+    Scenario scenario;
+
+    if (!scenario.load(scenarioFiles[i]))
+    {
+      std::cerr << "cannot read scenario from " << scenarioFiles[i] << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    AllocationCounter::Snapshot before = AllocationCounter::get();
+    TutorialPlanSystem system(scenario.sceneFile, scenario.kinematicsFile);
+    AllocationCounter::Snapshot after = AllocationCounter::get();
+
+    //  What the scene, the robot and the planners hold before the first query
+    std::cerr << scenario.name << ": " << after.live - before.live << " bytes of heap for the scene and the system" << std::endl;
+
+    if (!scenario.generate(system))
+    {
+      std::cerr << "cannot generate the queries of " << scenarioFiles[i] << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (std::size_t j = 0; j < scenario.queries.size(); ++j)
+    {
+      if (static_cast<std::size_t>(scenario.queries[j].start.size()) != system.getModel().getDof())
+      {
+        std::cerr << "query " << scenario.queries[j].name << " of " << scenarioFiles[i] << " does not match the robot" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    Benchmark benchmark(system);
+    benchmark.seed = seed;
+    benchmark.perfCounters = &counters;
+    benchmark.timeout = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeout));
+    benchmark.onTrial = [](const BenchmarkTrial& trial)
+    {
+      std::cerr << trial.scenario << "/" << trial.query << " " << trial.configuration << " #" << trial.trial << ": "
+                << (trial.result.solved ? "solved" : "failed") << " in " << trial.result.duration << " ms" << std::endl;
+    };
+
+    std::vector<BenchmarkTrial> scenarioResults = benchmark.run(scenario, configurations, trials);
+    results.insert(results.end(), scenarioResults.begin(), scenarioResults.end());
+  }
+  std::vector<BenchmarkStatistics> statistics = Benchmark::summarize(results);
+
+  if (!traceFile.empty())
+  {
+    Trace::stop();
+
+    if (!Trace::write(traceFile))
+    {
+      std::cerr << "cannot write trace to " << traceFile << std::endl;
+    }
+  }
+
+  std::ofstream csv(csvFile.c_str(), std::ios::trunc);
+  Benchmark::writeTrials(csv, results);
+
+  std::ofstream summary(summaryFile.c_str(), std::ios::trunc);
+  Benchmark::writeStatistics(summary, statistics);
+
+  std::ofstream json(jsonFile.c_str(), std::ios::trunc);
+  Benchmark::writeJson(json, results, statistics);
+
+  std::cout << std::left << std::setw(20) << "query" << std::setw(8) << "" << std::setw(28) << "configuration" << std::right
+            << std::setw(8) << "solved" << std::setw(12) << "median" << std::setw(12) << "p90" << std::setw(12) << "p99"
+            << std::setw(10) << "vertices" << std::setw(12) << "queries" << std::setw(12) << "free"
+            << std::setw(12) << "~tree KiB" << std::setw(10) << "~B/vertex" << std::setw(12) << "peak KiB";
+
+  if (counters.isOpen())
+  {
+    std::cout << std::setw(8) << "ipc" << std::setw(12) << "cache mpki" << std::setw(12) << "branch mpki";
+  }
+
+  std::cout << std::endl;
+
+  for (std::size_t i = 0; i < statistics.size(); ++i)
+  {
+    const BenchmarkStatistics& entry = statistics[i];
+    std::cout << std::left << std::setw(20) << entry.scenario + "/" + entry.query << std::setw(8) << ScenarioQuery::getName(entry.difficulty) << std::setw(28) << entry.configuration << std::right
+              << std::setw(7) << entry.solveRate * 100 << "%" << std::setw(12) << entry.median << std::setw(12) << entry.p90
+              << std::setw(12) << entry.p99 << std::setw(10) << entry.vertices << std::setw(12) << entry.totalQueries
+              << std::setw(12) << entry.freeQueries << std::setw(12) << entry.treeBytes / 1024 << std::setw(10) << entry.vertexBytes
+              << std::setw(12) << entry.peakBytes / 1024;
+
+    if (counters.isOpen())
+    {
+      std::cout << std::setw(8) << entry.ipc << std::setw(12) << entry.cacheMpki << std::setw(12) << entry.branchMpki;
+    }
+
+    std::cout << std::endl;
+  }
+
+  if (!baselineFile.empty())
+  {
+    std::vector<RegressionComparison> comparisons = regression.compare(baseline, results);
+
+    std::ofstream regressions(regressionsFile.c_str(), std::ios::trunc);
+    Regression::writeJson(regressions, comparisons);
+
+    std::ofstream regressionsCsv(regressionsCsvFile.c_str(), std::ios::trunc);
+    Regression::writeCsv(regressionsCsv, comparisons);
+
+    for (std::size_t i = 0; i < comparisons.size(); ++i)
+    {
+      const RegressionComparison& entry = comparisons[i];
+
+      if (entry.regressed)
+      {
+        std::cout << "regression: " << entry.scenario << "/" << entry.query << " " << entry.configuration << " " << entry.metric
+                  << " median " << entry.baselineMedian << " -> " << entry.currentMedian << " (p = " << entry.p << ")" << std::endl;
+      }
+    }
+
+    if (comparisons.empty())
+    {
+      std::cerr << "no query and configuration of the baseline was rerun, check --scenario" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    //  Comparing builds: run the baseline with one build and this with another on the same seeds
+    std::cout << "speedup of " << Benchmark::getBuild() << " against " << baselineFile << ": " << Regression::speedup(comparisons) << std::endl;
+
+    //  Distinct from the failures above, so a caller can tell a slower planner from a broken run
+    if (Regression::isRegressed(comparisons))
+    {
+      return 2;
+    }
+
+    std::cout << "no regression against " << baselineFile << " in " << comparisons.size() << " comparisons" << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
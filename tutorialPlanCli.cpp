@@ -0,0 +1,197 @@
+#include <Inventor/SoDB.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BatchPlanner.h"
+#include "Scenario.h"
+#include "Trace.h"
+#include "TutorialPlanSystem.h"
+
+//  Plans the start and goal configuration of the TutorialPlanSystem once, like the plan button of the GUI.
+int
+single(bool useRoadmap, bool useExperience, const std::string& sampleCacheFile)
+{
+  TutorialPlanSystem system;
+  system.setUseRoadmap(useRoadmap);
+  system.setUseExperience(useExperience);
+  system.setSampleCacheFile(sampleCacheFile);
+
+  //  In anytime mode the planner keeps shortening its first solution, report every improvement
+  system.getYourPlanner().on_improvement = [](const rl::plan::VectorList& path, rl::math::Real cost)
+  {
+    std::cout << "improved path: length " << cost << ", " << path.size() << " vertices" << std::endl;
+  };
+
+  rl::plan::VectorList path;
+  return system.plan(path) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//  Draws the random queries of a scenario and prints it with all queries listed.
+int
+generate(const std::string& filename)
+{
+  Scenario scenario;
+
+  if (!scenario.load(filename))
+  {
+    std::cerr << "cannot read scenario from " << filename << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  TutorialPlanSystem system(scenario.sceneFile, scenario.kinematicsFile);
+
+  if (!scenario.generate(system))
+  {
+    std::cerr << "cannot generate the queries of " << filename << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  scenario.save(std::cout);
+
+  return EXIT_SUCCESS;
+}
+
+//  Plans all queries of a file, one TutorialPlanSystem per worker thread.
+int
+batch(const std::string& filename, std::size_t threads)
+{
+  std::vector< std::shared_ptr<TutorialPlanSystem> > systems;
+  std::vector<TutorialPlanSystem*> workers;
+
+  for (std::size_t i = 0; i < threads; ++i)
+  {
+    systems.push_back(std::make_shared<TutorialPlanSystem>());
+    workers.push_back(systems.back().get());
+  }
+
+  std::vector<Query> queries;
+
+  if (!BatchPlanner::readQueries(filename, workers.front()->getModel().getDof(), queries))
+  {
+    std::cerr << "cannot read queries from " << filename << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  BatchPlanner planner(workers);
+  std::vector<QueryResult> results = planner.run(queries);
+
+  std::ofstream csv("batch.csv", std::ios::trunc);
+  BatchPlanner::writeResults(csv, results);
+  planner.writeSummary(std::cout, results);
+
+  return EXIT_SUCCESS;
+}
+
+int
+usage(const char* name)
+{
+  std::cerr << "usage: " << name << " [--trace file] [--roadmap] [--experience] [--sample-cache file]" << std::endl;
+  std::cerr << "       " << name << " [--trace file] --batch queries.txt [threads]" << std::endl;
+  std::cerr << "       " << name << " --generate scenario.txt" << std::endl;
+  return EXIT_FAILURE;
+}
+
+int
+run(const char* name, const std::vector<std::string>& args)
+{
+  if (!args.empty() && "--batch" == args[0])
+  {
+    if (args.size() < 2)
+    {
+      return usage(name);
+    }
+
+    std::size_t threads = args.size() > 2 ? std::strtoul(args[2].c_str(), NULL, 10) : std::thread::hardware_concurrency();
+    return batch(args[1], std::max<std::size_t>(threads, 1));
+  }
+
+  if (!args.empty() && "--generate" == args[0])
+  {
+    return args.size() == 2 ? generate(args[1]) : usage(name);
+  }
+
+  bool useRoadmap = false;
+  bool useExperience = false;
+  std::string sampleCacheFile;
+
+  for (std::size_t i = 0; i < args.size(); ++i)
+  {
+    if ("--roadmap" == args[i])
+    {
+      useRoadmap = true;
+    }
+    else if ("--experience" == args[i])
+    {
+      useExperience = true;
+    }
+    else if ("--sample-cache" == args[i] && i + 1 < args.size())
+    {
+      sampleCacheFile = args[++i];
+    }
+    else
+    {
+      return usage(name);
+    }
+  }
+
+  return single(useRoadmap, useExperience, sampleCacheFile);
+}
+
+int
+main(int argc, char** argv)
+{
+  //  --trace file can be given in every mode
+  std::string traceFile;
+  std::vector<std::string> args;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+    {
+      traceFile = argv[++i];
+    }
+    else
+    {
+      args.push_back(argv[i]);
+    }
+  }
+
+  if (!traceFile.empty())
+  {
+    if (!Trace::isEnabled())
+    {
+      std::cerr << "--trace needs a build with TUTORIAL_PLAN_TRACE" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    Trace::start();
+    Trace::setThreadName("main");
+  }
+
+  //  The scenes are read with coin, but nothing is shown, so neither qt nor soqt are initialized.
+  SoDB::init();
+
+  int status = run(argv[0], args);
+
+  if (!traceFile.empty())
+  {
+    Trace::stop();
+
+    if (!Trace::write(traceFile))
+    {
+      std::cerr << "cannot write trace to " << traceFile << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cerr << "trace written to " << traceFile << ", " << Trace::getDropped() << " spans dropped" << std::endl;
+  }
+
+  return status;
+}
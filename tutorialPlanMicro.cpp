@@ -0,0 +1,363 @@
+#include <Inventor/SoDB.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <rl/plan/AdvancedOptimizer.h>
+#include <rl/plan/RecursiveVerifier.h>
+
+#include "AllocationCounter.h"
+#include "TutorialPlanSystem.h"
+#include "YourPlanner.h"
+#include "YourSampler.h"
+#include "rl/math/Unit.h"
+
+//  Makes the protected primitives of YourPlanner callable from the benchmarks
+class PlannerProbe : public YourPlanner
+{
+public:
+  using YourPlanner::Neighbor;
+  using YourPlanner::Tree;
+  using YourPlanner::Vertex;
+  using YourPlanner::addVertex;
+  using YourPlanner::connect;
+  using YourPlanner::extend;
+  using YourPlanner::nearest;
+  using YourPlanner::tree;
+  using YourPlanner::updateBasis;
+};
+
+//  Cost of one primitive, averaged over all operations
+struct Measurement
+{
+  std::string name;
+  std::size_t operations;
+  double nanoseconds; //per operation
+  double allocations; //per operation
+  double bytes; //allocated per operation
+};
+
+//  Keeps the compiler from dropping the results of the measured calls
+volatile rl::math::Real sink = 0;
+
+Measurement
+result(const std::string& name, std::size_t operations, std::chrono::steady_clock::duration elapsed, const AllocationCounter::Snapshot& before, const AllocationCounter::Snapshot& after)
+{
+  Measurement measurement;
+  measurement.name = name;
+  measurement.operations = operations;
+  measurement.nanoseconds = std::chrono::duration_cast< std::chrono::duration<double, std::nano> >(elapsed).count() / operations;
+  measurement.allocations = static_cast<double>(after.allocations - before.allocations) / operations;
+  measurement.bytes = static_cast<double>(after.bytes - before.bytes) / operations;
+  return measurement;
+}
+
+//  Times operations calls of operation(i) as a whole, for primitives too short to time one by one
+template<typename Operation>
+Measurement
+measure(const std::string& name, std::size_t operations, Operation operation)
+{
+  AllocationCounter::Snapshot before = AllocationCounter::get();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  for (std::size_t i = 0; i < operations; ++i)
+  {
+    operation(i);
+  }
+
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+  AllocationCounter::Snapshot after = AllocationCounter::get();
+
+  return result(name, operations, elapsed, before, after);
+}
+
+//  Times operation(i) alone, prepare(i) runs before it untimed and uncounted
+template<typename Prepare, typename Operation>
+Measurement
+measureEach(const std::string& name, std::size_t operations, Prepare prepare, Operation operation)
+{
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::duration::zero();
+  AllocationCounter::Snapshot before = {0, 0, 0, 0, 0};
+  AllocationCounter::Snapshot after = {0, 0, 0, 0, 0};
+
+  for (std::size_t i = 0; i < operations; ++i)
+  {
+    prepare(i);
+
+    AllocationCounter::Snapshot first = AllocationCounter::get();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    operation(i);
+    elapsed += std::chrono::steady_clock::now() - start;
+    AllocationCounter::Snapshot last = AllocationCounter::get();
+
+    after.allocations += last.allocations - first.allocations;
+    after.bytes += last.bytes - first.bytes;
+  }
+
+  return result(name, operations, elapsed, before, after);
+}
+
+int
+usage(const char* name)
+{
+  std::cerr << "usage: " << name << " [--scenario file] [--seed s] [--csv file]" << std::endl;
+  return EXIT_FAILURE;
+}
+
+int
+main(int argc, char** argv)
+{
+  std::string scenarioFile = "../scenarios/wall.txt";
+  std::mt19937::result_type seed = 1;
+  std::string csvFile = "micro.csv";
+
+  for (int i = 1; i < argc; ++i)
+  {
+    bool value = i + 1 < argc;
+
+    if (value && std::strcmp(argv[i], "--scenario") == 0)
+    {
+      scenarioFile = argv[++i];
+    }
+    else if (value && std::strcmp(argv[i], "--seed") == 0)
+    {
+      seed = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (value && std::strcmp(argv[i], "--csv") == 0)
+    {
+      csvFile = argv[++i];
+    }
+    else
+    {
+      return usage(argv[0]);
+    }
+  }
+
+  Scenario scenario;
+
+  if (!scenario.load(scenarioFile))
+  {
+    std::cerr << "cannot read scenario from " << scenarioFile << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  //  The scenes are read with coin, but nothing is shown
+  SoDB::init();
+
+  TutorialPlanSystem system(scenario.sceneFile, scenario.kinematicsFile);
+
+  rl::plan::DistanceModel& model = system.getModel();
+  rl::math::Vector start = system.getStartConfiguration();
+  rl::math::Vector goal = system.getGoalConfiguration();
+
+  //  The first fixed query of the scenario, if it has one
+  if (!scenario.queries.empty() && static_cast<std::size_t>(scenario.queries.front().start.size()) == model.getDof())
+  {
+    start = scenario.queries.front().start;
+    goal = scenario.queries.front().goal;
+  }
+
+  rl::plan::YourSampler sampler;
+  sampler.model = &model;
+  sampler.seed(seed);
+
+  PlannerProbe planner;
+  planner.delta = 1 * rl::math::DEG2RAD;
+  planner.epsilon = 1.0e-8f;
+  planner.model = &model;
+  planner.sampler = &sampler;
+  planner.start = &start;
+  planner.goal = &goal;
+  planner.updateBasis();
+
+  sampler.setSigma(planner.sigma);
+  sampler.setTubeSigma(planner.tube_sigma);
+  sampler.maxAttempts = planner.sampling_budget;
+
+  model.setPosition(goal);
+  model.updateFrames();
+  sampler.setWorkspaceTarget(model.forwardPosition());
+
+  //  Fixed random configurations and pairs of them the primitives are applied to
+  const std::size_t samples = 1000;
+  std::vector<rl::math::Vector> configurations;
+
+  for (std::size_t i = 0; i < samples; ++i)
+  {
+    configurations.push_back(sampler.generate());
+  }
+
+  std::vector<Measurement> measurements;
+
+  //  Linear nearest neighbour search in trees of several sizes
+  const std::size_t sizes[] = {100, 1000, 10000};
+
+  for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+  {
+    planner.tree[0].clear();
+
+    for (std::size_t j = 0; j < sizes[i]; ++j)
+    {
+      planner.addVertex(planner.tree[0], std::make_shared<rl::math::Vector>(sampler.generate()));
+    }
+
+    measurements.push_back(measure("nearest/" + std::to_string(sizes[i]), samples, [&](std::size_t k)
+    {
+      sink = sink + planner.nearest(planner.tree[0], configurations[k]).second;
+    }));
+  }
+
+  //  Extend and connect a tree rooted at start towards the fixed configurations
+  PlannerProbe::Neighbor neighbor;
+
+  planner.tree[0].clear();
+  planner.addVertex(planner.tree[0], std::make_shared<rl::math::Vector>(start));
+
+  measurements.push_back(measureEach("extend", samples, [&](std::size_t k)
+  {
+    neighbor = planner.nearest(planner.tree[0], configurations[k]);
+  }, [&](std::size_t k)
+  {
+    sink = sink + (NULL != planner.extend(planner.tree[0], neighbor, configurations[k]));
+  }));
+
+  planner.tree[0].clear();
+  planner.addVertex(planner.tree[0], std::make_shared<rl::math::Vector>(start));
+
+  measurements.push_back(measureEach("connect", samples, [&](std::size_t k)
+  {
+    neighbor = planner.nearest(planner.tree[0], configurations[k]);
+  }, [&](std::size_t k)
+  {
+    sink = sink + (NULL != planner.connect(planner.tree[0], neighbor, configurations[k]));
+  }));
+
+  planner.tree[0].clear();
+
+  //  Every generator from the same seed
+  sampler.seed(seed);
+  measurements.push_back(measure("generate", samples, [&](std::size_t)
+  {
+    sink = sink + sampler.generate()(0);
+  }));
+
+  sampler.seed(seed);
+  measurements.push_back(measure("generateCollisionFree", samples, [&](std::size_t)
+  {
+    sink = sink + sampler.generateCollisionFree()(0);
+  }));
+
+  sampler.seed(seed);
+  measurements.push_back(measure("generateGaussian", samples, [&](std::size_t)
+  {
+    sink = sink + sampler.generateGaussian()(0);
+  }));
+
+  sampler.seed(seed);
+  measurements.push_back(measure("generateBridge", samples, [&](std::size_t)
+  {
+    sink = sink + sampler.generateBridge()(0);
+  }));
+
+  sampler.seed(seed);
+  measurements.push_back(measure("generateGaussianAlongCPath", samples, [&](std::size_t)
+  {
+    sink = sink + sampler.generateGaussianAlongCPath(planner.Q, start, planner.lengthStartGoal)(0);
+  }));
+
+  const rl::math::Real cost = 1.5 * model.distance(start, goal);
+
+  sampler.seed(seed);
+  measurements.push_back(measure("generateInformed", samples, [&](std::size_t)
+  {
+    sink = sink + sampler.generateInformed(planner.Q, start, goal, cost)(0);
+  }));
+
+  sampler.seed(seed);
+  measurements.push_back(measure("generateWorkspace", samples, [&](std::size_t)
+  {
+    sink = sink + sampler.generateWorkspace()(0);
+  }));
+
+  //  One collision query, the model is moved to the configuration first
+  measurements.push_back(measure("setPosition+updateFrames+isColliding", samples, [&](std::size_t k)
+  {
+    model.setPosition(configurations[k]);
+    model.updateFrames();
+    sink = sink + model.isColliding();
+  }));
+
+  //  Metric and interpolation on pairs of the fixed configurations
+  const std::size_t pairs = 100 * samples;
+  rl::math::Vector q(model.getDof());
+
+  measurements.push_back(measure("interpolate", pairs, [&](std::size_t k)
+  {
+    model.interpolate(configurations[k % samples], configurations[(k + 1) % samples], 0.5, q);
+    sink = sink + q(0);
+  }));
+
+  measurements.push_back(measure("distance", pairs, [&](std::size_t k)
+  {
+    sink = sink + model.distance(configurations[k % samples], configurations[(k + 1) % samples]);
+  }));
+
+  //  Optimizing a solution of the query, each time on a fresh copy of it
+  system.setStartConfiguration(start);
+  system.setGoalConfiguration(goal);
+  system.seed(seed);
+  system.getYourPlanner().duration = std::chrono::seconds(60);
+
+  if (system.getYourPlanner().solve())
+  {
+    rl::plan::VectorList solution = system.getYourPlanner().getPath();
+    rl::plan::VectorList path;
+
+    rl::plan::RecursiveVerifier verifier;
+    verifier.delta = 1 * rl::math::DEG2RAD;
+    verifier.model = &model;
+
+    rl::plan::AdvancedOptimizer optimizer;
+    optimizer.length = 15 * rl::math::DEG2RAD;
+    optimizer.ratio = 0.05;
+    optimizer.verifier = &verifier;
+    optimizer.model = &model;
+
+    measurements.push_back(measureEach("AdvancedOptimizer::process", 10, [&](std::size_t)
+    {
+      path = solution;
+    }, [&](std::size_t)
+    {
+      optimizer.process(path);
+    }));
+  }
+  else
+  {
+    std::cerr << "no solution to optimize within 60 s, skipping AdvancedOptimizer::process" << std::endl;
+  }
+
+  std::ofstream csv(csvFile.c_str(), std::ios::trunc);
+  csv << "name,operations,ns_per_op,allocations_per_op,bytes_per_op" << std::endl;
+
+  std::cout << std::left << std::setw(40) << "primitive" << std::right << std::setw(10) << "ops" << std::setw(14) << "ns/op"
+            << std::setw(14) << "allocs/op" << std::setw(14) << "bytes/op" << std::endl;
+
+  for (std::size_t i = 0; i < measurements.size(); ++i)
+  {
+    const Measurement& entry = measurements[i];
+
+    csv << entry.name << "," << entry.operations << "," << entry.nanoseconds << "," << entry.allocations << "," << entry.bytes << std::endl;
+
+    std::cout << std::left << std::setw(40) << entry.name << std::right << std::setw(10) << entry.operations
+              << std::setw(14) << std::fixed << std::setprecision(1) << entry.nanoseconds
+              << std::setw(14) << std::setprecision(2) << entry.allocations
+              << std::setw(14) << std::setprecision(1) << entry.bytes << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}